@@ -0,0 +1,93 @@
+#include "active_keys.hpp"
+#include "key.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+
+#include <SDL3/SDL.h>
+
+using std::array;
+using std::optional;
+using std::size_t;
+
+/**
+ * the per frame key queries EventLoop makes, one by one and batched
+ * build with -DBUILD_BENCHMARKS=ON and run 3dgraph_bench
+ */
+
+static constexpr size_t iterations = 1'000'000;
+
+static constexpr array queried_scan_codes = {
+    SDL_SCANCODE_UP, SDL_SCANCODE_DOWN, SDL_SCANCODE_LEFT, SDL_SCANCODE_RIGHT,
+    SDL_SCANCODE_W,  SDL_SCANCODE_S,    SDL_SCANCODE_A,    SDL_SCANCODE_D,
+};
+
+namespace {
+template <typename F> double ns_per_iteration(F &&f) {
+    auto const start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        f(i);
+    }
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+           static_cast<double>(iterations);
+}
+} // namespace
+
+int main() {
+    if (!SDL_Init(SDL_INIT_EVENTS)) {
+        std::fprintf(stderr, "could not init sdl\n");
+        return 1;
+    }
+
+    ActiveKeys active_keys{SDL_SCANCODE_W,  SDL_SCANCODE_A,    SDL_SCANCODE_S,    SDL_SCANCODE_D,
+                           SDL_SCANCODE_UP, SDL_SCANCODE_DOWN, SDL_SCANCODE_LEFT, SDL_SCANCODE_RIGHT,
+                           SDL_SCANCODE_E,  SDL_SCANCODE_F};
+    active_keys.press_key(Key{SDL_SCANCODE_W});
+    active_keys.press_key(Key{SDL_SCANCODE_LEFT});
+
+    // keeps the optimizer from dropping the queries
+    size_t held_keys = 0;
+    auto const start_ms = SDL_GetTicks();
+    auto const start_ns = SDL_GetTicksNS();
+
+    auto const single = ::ns_per_iteration([&](size_t i) {
+        for (auto const scan_code : queried_scan_codes) {
+            held_keys += active_keys.which_key_variant_was_pressed_since(start_ms, start_ms + i, scan_code).has_value();
+        }
+    });
+
+    array<optional<KeyAtTime>, queried_scan_codes.size()> results;
+    auto const batched = ::ns_per_iteration([&](size_t i) {
+        active_keys.which_key_variants_were_pressed_since(start_ms, start_ms + i, queried_scan_codes, results);
+        for (auto const &result : results) {
+            held_keys += result.has_value();
+        }
+    });
+
+    array<HeldDuration, queried_scan_codes.size()> durations;
+    auto const held = ::ns_per_iteration([&](size_t i) {
+        active_keys.held_durations(start_ns, start_ns + i, queried_scan_codes, durations);
+        for (auto const &duration : durations) {
+            held_keys += duration.total_ns() != 0;
+        }
+    });
+
+    auto const press_release = ::ns_per_iteration([&](size_t) {
+        active_keys.press_key(Key{SDL_SCANCODE_S, KeyMod::none()});
+        active_keys.release_key(Key{SDL_SCANCODE_S, KeyMod::none()});
+    });
+
+    std::printf("%zu keys held\n", held_keys);
+    std::printf("8 single queries: %8.1f ns / frame\n", single);
+    std::printf("1 batched query:  %8.1f ns / frame\n", batched);
+    std::printf("held durations:   %8.1f ns / frame\n", held);
+    std::printf("press + release:  %8.1f ns\n", press_release);
+
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,50 @@
+# generates a header with every shader under SHADERS_DIR embedded as constexpr string data
+# usage: cmake -DSHADERS_DIR=<dir> -DOUTPUT=<header> -P embed_shaders.cmake
+
+if(NOT DEFINED SHADERS_DIR OR NOT DEFINED OUTPUT)
+  message(FATAL_ERROR "SHADERS_DIR and OUTPUT must be defined")
+endif()
+
+file(GLOB_RECURSE shader_files RELATIVE ${SHADERS_DIR} ${SHADERS_DIR}/*.glsl)
+list(SORT shader_files)
+
+set(content "// generated by cmake/embed_shaders.cmake from ${SHADERS_DIR}, do not edit\n")
+string(APPEND content "#pragma once\n\n")
+string(APPEND content "#include \"embedded_shader.hpp\"\n\n")
+string(APPEND content "#include <array>\n#include <optional>\n#include <string_view>\n\n")
+string(APPEND content "inline constexpr std::array embedded_shaders{\n")
+
+foreach(shader_file ${shader_files})
+  file(READ ${SHADERS_DIR}/${shader_file} shader_source)
+  string(FIND "${shader_source}" ")glsl\"" delimiter_found)
+  if(NOT delimiter_found EQUAL -1)
+    message(FATAL_ERROR "${shader_file} contains the raw string delimiter )glsl\"")
+  endif()
+
+  string(APPEND content "    EmbeddedShader{\"${shader_file}\", R\"glsl(${shader_source})glsl\"},\n")
+endforeach()
+
+string(APPEND content "};\n\n")
+string(APPEND content "/**\n * @param name path of the shader relative to the shaders directory\n")
+string(APPEND content " * @return the embedded shader or nullopt if it was not found at build time\n */\n")
+string(APPEND content "[[nodiscard]] constexpr std::optional<EmbeddedShader> find_embedded_shader(std::string_view name) {\n")
+string(APPEND content "    for (auto const &shader : embedded_shaders) {\n")
+string(APPEND content "        if (shader.name == name) {\n")
+string(APPEND content "            return shader;\n")
+string(APPEND content "        }\n")
+string(APPEND content "    }\n\n")
+string(APPEND content "    return std::nullopt;\n")
+string(APPEND content "}\n\n")
+string(APPEND content "/**\n * compile time checked version of find_embedded_shader\n */\n")
+string(APPEND content "[[nodiscard]] consteval EmbeddedShader embedded_shader(std::string_view name) {\n")
+string(APPEND content "    auto const shader = find_embedded_shader(name);\n")
+string(APPEND content "    if (!shader.has_value()) {\n")
+string(APPEND content "        throw \"shader was not embedded at build time\";\n")
+string(APPEND content "    }\n\n")
+string(APPEND content "    return *shader;\n")
+string(APPEND content "}\n")
+
+# only touch the output when the content changed to avoid needless rebuilds
+file(WRITE ${OUTPUT}.tmp "${content}")
+configure_file(${OUTPUT}.tmp ${OUTPUT} COPYONLY)
+file(REMOVE ${OUTPUT}.tmp)
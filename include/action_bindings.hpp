@@ -0,0 +1,120 @@
+#pragma once
+
+#include "active_keys.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+/**
+ * what a bound key does, the shifted variants of orbiting and panning are actions of their own
+ */
+enum class Action : std::uint8_t {
+    pan_x_positive,
+    pan_x_negative,
+    pan_y_positive,
+    pan_y_negative,
+    z_mult_up,
+    z_mult_down,
+    orbit_up,
+    orbit_down,
+    orbit_left,
+    orbit_right,
+    slow_orbit_up,
+    slow_orbit_down,
+    slow_orbit_left,
+    slow_orbit_right,
+    tessellation_up,
+    tessellation_down,
+    toggle_wireframe,
+    next_function,
+};
+
+/**
+ * a key, with or without shift, doing an action
+ */
+struct Binding {
+    Action action;
+    SDL_Scancode scan_code;
+    bool shifted;
+};
+
+/**
+ * @brief which action each key does, compiled into a table indexed by scan code and shift
+ * @details looking up the action of a key is one array index. a key bound without shift does the same with
+ * shift, unless its shifted variant is bound to something else. only shift is supported as a modifier, like
+ * ActiveKeys
+ */
+class ActionBindings {
+public:
+    static constexpr std::size_t num_actions = static_cast<std::size_t>(Action::next_function) + 1;
+
+    /** how long each action was held, indexed by Action */
+    using ActionDurations = std::array<uint64_t, num_actions>;
+
+private:
+    /** slot of a key that does nothing */
+    static constexpr uint8_t unbound = UINT8_MAX;
+
+    /** unshifted and shifted variant of each scan code next to each other, the same layout as ActiveKeys */
+    static constexpr std::size_t variants_per_scan_code = 2;
+
+    std::array<uint8_t, static_cast<std::size_t>(SDL_SCANCODE_COUNT) * variants_per_scan_code> slots;
+
+    /** as bound, for queries about presses */
+    std::vector<Binding> bindings;
+
+    /** every scan code bound to something, each once, in the order first bound */
+    std::vector<SDL_Scancode> scan_codes;
+
+public:
+    /**
+     * @throws InputError if a key is bound twice or is out of range
+     */
+    explicit ActionBindings(std::span<Binding const> bindings);
+
+    /**
+     * the keys listed in the controls section of the readme
+     */
+    [[nodiscard]] static ActionBindings defaults();
+
+    /**
+     * one binding per line, `action = key` or `action = shift+key` with the key named as by SDL_GetScancodeName.
+     * blank lines and lines starting with # are skipped
+     * @throws InputError naming the line of the first problem
+     */
+    [[nodiscard]] static ActionBindings parse(std::istream &in);
+
+    /**
+     * @throws InputError if the file can not be read, or see parse
+     */
+    [[nodiscard]] static ActionBindings load(std::filesystem::path const &path);
+
+    /**
+     * @return the action of the key, nullopt if it is not bound
+     */
+    [[nodiscard]] std::optional<Action> lookup(SDL_Scancode scan_code, bool shifted) const noexcept;
+
+    [[nodiscard]] std::span<Binding const> get_bindings() const noexcept;
+
+    /**
+     * what ActiveKeys needs to monitor, and the order held_ns expects its durations in
+     */
+    [[nodiscard]] std::span<SDL_Scancode const> get_scan_codes() const noexcept;
+
+    /**
+     * @param held how long each of get_scan_codes was held, see ActiveKeys::held_durations
+     * @return how long each action was held, the time of every key bound to it added up
+     */
+    [[nodiscard]] ActionDurations held_ns(std::span<HeldDuration const> held) const noexcept;
+
+    [[nodiscard]] static std::string_view get_action_name(Action action) noexcept;
+};
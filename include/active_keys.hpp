@@ -1,43 +1,115 @@
 #pragma once
 
 #include "key.hpp"
+#include "press_history.hpp"
 
 #include <SDL3/SDL.h>
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <expected>
 #include <initializer_list>
 #include <optional>
 #include <ranges>
+#include <span>
 #include <string>
-#include <unordered_map>
+#include <tuple>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 #include <version>
 
 // TODO: refactor to make private
-using Interval = std::pair<uint64_t, std::optional<uint64_t>>;
 using KeyValue = std::optional<Interval>;
 using KeySet = std::unordered_set<Key, KeyEquivalentHash<>, KeyEquivalentEqualTo<>>;
 using KeyAtTime = std::tuple<Key, uint64_t, uint64_t>;
 
+/**
+ * how long a scan code was held within a window, split by whether shift was held with it
+ */
+struct HeldDuration {
+    uint64_t unshifted_ns = 0;
+    uint64_t shifted_ns = 0;
+
+    [[nodiscard]] uint64_t total_ns() const noexcept {
+        return unshifted_ns + shifted_ns;
+    }
+};
+
 class ActiveKeys {
+    /** slot of a key that is not monitored */
+    static constexpr uint16_t unregistered = UINT16_MAX;
+
+    /** unshifted and shifted variant of each scan code next to each other, see slot_index */
+    static constexpr std::size_t variants_per_scan_code = 2;
+
     /**
-     * missing from map = key is not monitored
+     * index into histories of every key with no modifier other than shift, indexed by scan code, so lookups
+     * are an array index instead of hashing a Key
      */
-    std::unordered_map<Key, KeyValue, KeyEquivalentHash<>, KeyEquivalentEqualTo<>> key_timings;
-    std::unordered_set<SDL_Scancode> registered_scan_codes;
+    using Slots = std::array<uint16_t, static_cast<std::size_t>(SDL_SCANCODE_COUNT) * variants_per_scan_code>;
+    Slots slots;
 
-    void _press_key(const Key &key, uint64_t now_ms);
-    void _release_key(const Key &key, uint64_t now_ms);
+    /** slots with no key registered, built at compile time so constructing is a copy */
+    static constexpr Slots no_slots = [] {
+        Slots empty{};
+        empty.fill(unregistered);
+        return empty;
+    }();
+
+    /** only allocated when a key is registered, pressing and releasing never allocates */
+    std::vector<PressHistory> histories;
+
+    /** keys registered with ctrl / alt / lock modifiers, rare enough to search linearly */
+    std::vector<std::pair<Key, PressHistory>> modded_keys;
+
+    void _press_key(const Key &key, uint64_t now_ns);
+    void _release_key(const Key &key, uint64_t now_ns);
 
     /**
-     * new copy of a key or nullopt
+     * start monitoring exactly this key, no checks
      */
-    [[nodiscard]] std::optional<Key> registered_key_or_empty(const Key &key) const;
+    void register_key(const Key &key);
+
+    /**
+     * @return the presses of this exact key or nullptr if it is not registered
+     */
+    [[nodiscard]] PressHistory *find_history(const Key &key);
+    [[nodiscard]] PressHistory const *find_history(const Key &key) const;
+
+    /**
+     * @return the presses of a densely stored key or nullptr if it is not registered
+     */
+    [[nodiscard]] PressHistory const *slot_history(std::size_t index) const;
+
+    [[nodiscard]] bool is_scan_code_registered(SDL_Scancode scan_code) const;
+
+    /**
+     * @return index into slots, or nullopt if the key has modifiers other than shift
+     */
+    [[nodiscard]] static constexpr std::optional<std::size_t> slot_index(const Key &key) {
+        auto const normalized = key.as_normalized();
+        auto const key_mod = normalized.get_key_mod();
+        if (key_mod != SDL_KMOD_NONE && key_mod != SDL_KMOD_SHIFT) {
+            return std::nullopt;
+        }
+
+        auto const scan_code = static_cast<std::size_t>(normalized.get_scan_code());
+        if (scan_code >= SDL_SCANCODE_COUNT) {
+            return std::nullopt;
+        }
+
+        return scan_code * variants_per_scan_code + (key_mod == SDL_KMOD_SHIFT ? 1 : 0);
+    }
+
+    [[nodiscard]] static std::optional<KeyAtTime> which_variant_was_pressed_since(uint64_t start_ms, uint64_t end_ms,
+                                                                                  SDL_Scancode scan_code,
+                                                                                  KeyValue const &unshifted_timing,
+                                                                                  KeyValue const &shifted_timing);
 
 public:
-    ActiveKeys() = default;
+    ActiveKeys();
 
     /**
      * if specifying a key w/o a modifier: it will also monitor the shift version of the key
@@ -56,74 +128,44 @@ public:
      */
     template <std::ranges::input_range R>
         requires std::same_as<std::ranges::range_value_t<R>, Key>
-    explicit ActiveKeys(R &&keys_to_monitor)
-        // clang-format off
-        : registered_scan_codes(std::from_range, std::forward<R>(keys_to_monitor) |
-                                std::views::transform([](auto key) { return key.get_scan_code(); })), 
-        key_timings(std::from_range, std::forward<R>(keys_to_monitor) |
-                      std::views::transform([](auto key) {
-                          return std::make_pair(key, std::nullopt);
-                      })) {
-        // clang-format on
+    explicit ActiveKeys(R &&keys_to_monitor) : ActiveKeys() {
         for (auto const key : std::forward<R>(keys_to_monitor)) {
             // TODO: another leaky abstraction, need to fix
-            key_timings.insert({key.copy_shifted(), std::nullopt});
+            register_key(key);
+            register_key(key.copy_shifted());
         }
     }
 
     template <std::ranges::input_range R>
         requires std::convertible_to<std::ranges::range_value_t<R>, SDL_Scancode>
-    explicit ActiveKeys(R &&scan_codes_to_monitor)
-        // clang-format off
-        : registered_scan_codes(std::from_range, std::forward<R>(scan_codes_to_monitor)), 
-        key_timings(std::from_range, std::forward<R>(scan_codes_to_monitor) |
-                      std::views::transform([](auto scan_code) {
-                          const Key key{scan_code};
-                          return std::make_pair(key, std::nullopt);
-                      })) {
-        // clang-format on
-        for (auto const key_code : std::forward<R>(scan_codes_to_monitor)) {
-            const Key key{key_code};
+    explicit ActiveKeys(R &&scan_codes_to_monitor) : ActiveKeys() {
+        for (auto const scan_code : std::forward<R>(scan_codes_to_monitor)) {
+            const Key key{static_cast<SDL_Scancode>(scan_code)};
             // TODO: another leaky abstraction, need to fix
-            key_timings.insert({key.copy_shifted(), std::nullopt});
+            register_key(key);
+            register_key(key.copy_shifted());
         }
     }
 
     template <std::ranges::input_range R>
         requires std::same_as<std::ranges::range_value_t<R>, SDL_Keycode>
-    explicit ActiveKeys(R &&key_codes_to_monitor)
-        // clang-format off
-        : key_timings(std::from_range, std::forward<R>(key_codes_to_monitor) |
-                      std::views::transform([](auto key_code) {
-                          const Key key{key_code};
-                          return std::make_pair(key, std::nullopt);
-                      })),
-          registered_scan_codes(std::from_range, key_timings |
-                                std::views::transform([](auto tpl) { return std::get<0>(tpl).get_scan_code(); })) {
-        // clang-format on
+    explicit ActiveKeys(R &&key_codes_to_monitor) : ActiveKeys() {
         for (auto const key_code : std::forward<R>(key_codes_to_monitor)) {
             const Key key{key_code};
             // TODO: another leaky abstraction, need to fix
-            key_timings.insert({key.copy_shifted(), std::nullopt});
+            register_key(key);
+            register_key(key.copy_shifted());
         }
     }
 
     template <std::ranges::input_range R>
         requires std::same_as<std::ranges::range_value_t<R>, Keyish>
-    explicit ActiveKeys(R &&keys_to_monitor)
-        // clang-format off
-        : key_timings(std::from_range, std::forward<R>(keys_to_monitor) |
-                      std::views::transform([](auto keyish) {
-                          const Key key{keyish};
-                          return std::make_pair(key, std::nullopt);
-                      })),
-          registered_scan_codes(std::from_range, key_timings |
-                                std::views::transform([](auto tpl) { return std::get<0>(tpl).get_scan_code(); })) {
-        // clang-format on
+    explicit ActiveKeys(R &&keys_to_monitor) : ActiveKeys() {
         for (auto const keyish : std::forward<R>(keys_to_monitor)) {
             const Key key{keyish};
             // TODO: another leaky abstraction, need to fix
-            key_timings.insert({key.copy_shifted(), std::nullopt});
+            register_key(key);
+            register_key(key.copy_shifted());
         }
     }
 #endif
@@ -145,6 +187,13 @@ public:
     void press_key(const Key &key);
     void release_key(const Key &key);
 
+    /**
+     * press / release at the time the event happened rather than when it is processed
+     * @param timestamp_ns SDL_GetTicksNS time, e.g. SDL_KeyboardEvent::timestamp
+     */
+    void press_key(const Key &key, uint64_t timestamp_ns);
+    void release_key(const Key &key, uint64_t timestamp_ns);
+
     /**
      * did this key's press start time occur before start_ms
      */
@@ -152,6 +201,11 @@ public:
     [[nodiscard]] bool was_key_pressed_since(SDL_Scancode scan_code, uint64_t start_ms) const;
     [[nodiscard]] bool was_key_pressed_since(SDL_Keycode key_code, uint64_t start_ms) const;
 
+    /**
+     * is this exact key down right now
+     */
+    [[nodiscard]] bool is_key_held(const Key &key) const;
+
     /**
      * sync the state with SDL_GetKeyboardState
      */
@@ -177,5 +231,26 @@ public:
     [[nodiscard]] std::optional<KeyAtTime> which_key_variant_was_pressed_since(uint64_t start_ms, uint64_t end_ms,
                                                                                SDL_Scancode scan_code) const;
 
+    /**
+     * which_key_variant_was_pressed_since for several scan codes in one pass
+     * @param[out] results one per scan code, must be the same size as scan_codes
+     */
+    void which_key_variants_were_pressed_since(uint64_t start_ms, uint64_t end_ms,
+                                               std::span<SDL_Scancode const> scan_codes,
+                                               std::span<std::optional<KeyAtTime>> results) const;
+
+    /**
+     * how long the scan code was held within [start_ns, end_ns] counting every press in between, so a key
+     * tapped several times in one frame moves things as far as it was actually held
+     */
+    [[nodiscard]] HeldDuration held_duration(uint64_t start_ns, uint64_t end_ns, SDL_Scancode scan_code) const;
+
+    /**
+     * held_duration for several scan codes in one pass
+     * @param[out] results one per scan code, must be the same size as scan_codes
+     */
+    void held_durations(uint64_t start_ns, uint64_t end_ns, std::span<SDL_Scancode const> scan_codes,
+                        std::span<HeldDuration> results) const;
+
     [[nodiscard]] std::expected<KeyValue, std::string> get(const Key &key) const;
 };
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string_view>
+
+/**
+ * shader source compiled into the binary by cmake/embed_shaders.cmake
+ * see the generated embedded_shaders.hpp for the list of all embedded shaders
+ */
+struct EmbeddedShader {
+    /** path relative to the shaders directory, e.g. es/vertex.glsl */
+    std::string_view name;
+    std::string_view source;
+};
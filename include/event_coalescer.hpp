@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include <SDL3/SDL.h>
+
+/** events taken off the sdl queue at a time, see coalesce_events */
+constexpr std::size_t event_batch_size = 64;
+
+/**
+ * @brief merge runs of events that only accumulate, in place, preserving order
+ * @details mouse wheel deltas and mouse motion are summed into the first event of their run, key repeats after
+ * the first for a scancode are dropped. key up / down, button and any other event ends every run and is always
+ * kept, so no state transition is ever lost however far behind the queue is
+ * @return how many events at the front of events are left to process
+ */
+std::size_t coalesce_events(std::span<SDL_Event> events);
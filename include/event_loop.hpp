@@ -1,36 +1,70 @@
 #pragma once
 
+#include "action_bindings.hpp"
 #include "active_keys.hpp"
+#include "event_coalescer.hpp"
 #include "function_params.hpp"
 #include "glad/glad.h"
+#include "input_recording.hpp"
 #include "key.hpp"
 #include "max_deque.hpp"
-#include "mouse_loc.hpp"
+#include "mouse_drag.hpp"
 #include "tessellation_settings.hpp"
 #include "tick_result.hpp"
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
 #include <tuple>
+#include <vector>
 
 #include <SDL3/SDL.h>
 #include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <spdlog/spdlog.h>
 
 using KeyAtTime = std::tuple<Key, uint64_t, uint64_t>;
 
 class EventLoop {
-    SDL_Event evt;
+    std::array<SDL_Event, event_batch_size> events;
     std::shared_ptr<glm::mat4> model;
     std::shared_ptr<glm::mat4> view;
     std::shared_ptr<glm::mat4> projection;
     std::shared_ptr<FunctionParams> function_params;
     std::shared_ptr<TessellationSettings> tessellation_settings;
     MaxDeque<uint64_t> event_poll_timings;
+
+    /** what the keys do, active_keys monitors exactly the keys bound here */
+    ActionBindings action_bindings;
     ActiveKeys active_keys;
 
+    /** how long each bound key was held this tick, queried from active_keys together, see get_scan_codes */
+    std::vector<HeldDuration> held_keys;
+
+    /** held_keys added up per action */
+    ActionBindings::ActionDurations held_actions_ns;
+
+    /**
+     * end of the window held keys were last integrated over. windows are back to back in event timestamp
+     * time, so no held time falls in between ticks however late the events are processed
+     */
+    uint64_t integrated_until_ns;
+
+    /** how fast the keys still held at integrated_until_ns rotate the model about x and y */
+    glm::vec2 model_rotation_rads_per_ns;
+
+    /** timestamp of the oldest input event not yet taken, 0 if none, see take_input_timestamp_ns */
+    uint64_t oldest_input_ns;
+
+    /** every tick's input while recording, see start_recording */
+    std::optional<InputRecording> recording;
+
+    /** when replaying, ticks come from here instead of the sdl queue and clock */
+    std::optional<InputReplay> replay;
+
     // logger
     std::shared_ptr<spdlog::logger> logger;
     std::shared_ptr<spdlog::logger> err;
@@ -38,29 +72,94 @@ class EventLoop {
     // state stuff
     std::optional<uint64_t> last_tessellation_change_at_msec;
     std::optional<uint64_t> last_wireframe_only_change_at_msec;
-    std::optional<MouseLoc> start_click;
+    std::optional<uint64_t> last_plotted_function_change_at_msec;
+
+    /** left drags orbit, right drags pan, applied once a tick however many motion events there were */
+    MouseDrag mouse_drag;
 
     /**
-     * drain the sdl event queue one time
+     * drain the sdl event queue one time, a batch at a time with runs of events coalesced
      * returns true if should exit due to quit event
      */
     [[nodiscard]] TickResult drain_event_queue(TickResult tick_result);
 
-    [[nodiscard]] TickResult process_function_mutation_keys(uint64_t start_ticks_ms, TickResult tick_result);
-    [[nodiscard]] TickResult process_model_mutation_keys(uint64_t start_ticks_ms, uint64_t end_ticks_ms,
-                                                         TickResult tick_result);
+    /**
+     * coalesce and process the first num_events of events
+     */
+    [[nodiscard]] TickResult process_batch(std::size_t num_events, TickResult tick_result);
+    [[nodiscard]] TickResult process_event(SDL_Event const &event, TickResult tick_result);
+    void note_input(uint64_t timestamp_ns) noexcept;
+
+    /**
+     * see ActiveKeys::was_key_pressed_since, for any key bound to the action
+     */
+    [[nodiscard]] bool was_action_pressed_since(Action action, uint64_t start_ms) const;
+
+    [[nodiscard]] TickResult process_function_mutation_keys(TickResult tick_result);
+    [[nodiscard]] TickResult process_model_mutation_keys(TickResult tick_result);
     [[nodiscard]] TickResult process_tessellation_mutation_keys(uint64_t start_ticks_ms, TickResult tick_result);
-    [[nodiscard]] TickResult process_view_mutation_events(bool scrolled_toward_user, TickResult tick_result);
+    [[nodiscard]] TickResult process_view_mutation_events(Sint32 scroll_steps, TickResult tick_result);
+    [[nodiscard]] TickResult process_mouse_drag(TickResult tick_result);
     [[nodiscard]] TickResult process_render_setting_keys(uint64_t start_ticks_ms, TickResult tick_result);
+    [[nodiscard]] TickResult process_plotted_function_keys(uint64_t start_ticks_ms, TickResult tick_result);
+
+    /**
+     * integrate held keys up to integrate_until_ns and act on them, the part of a tick after input is drained
+     */
+    [[nodiscard]] TickResult process_held_keys(uint64_t start_ticks_ms, uint64_t integrate_until_ns,
+                                               TickResult tick_result);
+
+    /**
+     * process_frame when replaying, waits until the next recorded tick is due then processes it
+     */
+    [[nodiscard]] TickResult replay_frame();
 
 public:
     /**
+     * waits for and processes input until there is just enough time left to render before the deadline
+     * @param deadline_ns SDL_GetTicksNS by which the frame should be presented, see FramePacer
+     * @param render_time_ns how long rendering is expected to take
      * @return how long the frame took to run
      */
-    [[nodiscard]] TickResult process_frame(uint64_t render_time_ns);
+    [[nodiscard]] TickResult process_frame(uint64_t deadline_ns, uint64_t render_time_ns);
+
+    /**
+     * @return SDL_GetTicksNS that held keys have been integrated into the model up to
+     */
+    [[nodiscard]] uint64_t get_integrated_until_ns() const noexcept;
+
+    /**
+     * @return rotation per ns about x and y of the keys still held at get_integrated_until_ns, for
+     * extrapolating the model up to when it is drawn
+     */
+    [[nodiscard]] glm::vec2 get_model_rotation_rads_per_ns() const noexcept;
+
+    /**
+     * for following input through to the screen, see LatencyTrace
+     * @return SDL timestamp of the oldest key or wheel event processed since the last call, 0 if none
+     */
+    [[nodiscard]] uint64_t take_input_timestamp_ns() noexcept;
+
+    /**
+     * record the events every tick from here on takes in, along with its clock readings
+     */
+    void start_recording();
+
+    /**
+     * @return what was recorded since start_recording, nullopt if not recording
+     */
+    [[nodiscard]] std::optional<InputRecording> const &get_recording() const noexcept;
+
+    /**
+     * from here on process the recorded ticks on a virtual clock instead of the sdl event queue, at the pace
+     * they were recorded at. the model, view and function parameters follow the same path as when recorded.
+     * exits once the recording runs out
+     * prereq: nothing processed yet
+     */
+    void start_replay(InputRecording const &recorded);
 
     EventLoop() = delete;
     EventLoop(std::shared_ptr<glm::mat4> const &model, std::shared_ptr<glm::mat4> const &view,
               std::shared_ptr<glm::mat4> const &projection, std::shared_ptr<FunctionParams> const &function_params,
-              std::shared_ptr<TessellationSettings> const &tessellation_settings);
+              std::shared_ptr<TessellationSettings> const &tessellation_settings, ActionBindings action_bindings);
 };
@@ -69,3 +69,12 @@ public:
     InputError(const char *msg) : std::runtime_error(msg) {
     }
 };
+
+/** malformed plotted function expression */
+class ExpressionError : public InputError {
+public:
+    ExpressionError(std::string const &msg) : InputError(msg) {
+    }
+    ExpressionError(const char *msg) : InputError(msg) {
+    }
+};
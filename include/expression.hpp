@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief operations of the plotted function expression language
+ * @details the language has the variables x and y, the constants pi and e, numbers, + - * / ^,
+ * and the functions sin cos tan sqrt abs exp log pow
+ */
+enum class ExpressionOp : uint8_t {
+    constant,
+    x,
+    y,
+    add,
+    subtract,
+    multiply,
+    divide,
+    power,
+    /** pow(a, 2.0) after strength reduction */
+    square,
+    negate,
+    sin,
+    cos,
+    tan,
+    sqrt,
+    abs,
+    exp,
+    log,
+};
+
+struct ExpressionNode {
+    ExpressionOp op;
+
+    /** only meaningful for ExpressionOp::constant */
+    double value;
+    std::vector<ExpressionNode> children;
+
+    [[nodiscard]] bool is_constant() const noexcept {
+        return op == ExpressionOp::constant;
+    }
+
+    [[nodiscard]] bool is_leaf() const noexcept {
+        return children.empty();
+    }
+};
+
+/**
+ * parse a user supplied formula of x and y, throws ExpressionError on malformed input
+ */
+[[nodiscard]] ExpressionNode parse_expression(std::string_view source);
+
+/**
+ * constant folding and strength reduction (e.g. pow(x, 2.0) -> x * x)
+ * throws ExpressionError if folding produces a non finite constant
+ */
+[[nodiscard]] ExpressionNode optimize_expression(ExpressionNode node);
+
+/**
+ * @return fully parenthesized canonical text of the expression, equivalent expressions after
+ * optimization have the same text
+ */
+[[nodiscard]] std::string expression_to_string(ExpressionNode const &node);
+
+/**
+ * @return glsl for the expression body, depends on the helpers in CompiledExpression::get_glsl
+ * throws ExpressionError if a constant is out of range of a float
+ */
+[[nodiscard]] std::string expression_to_glsl(ExpressionNode const &node);
+
+/**
+ * @brief stack machine evaluating an expression on the cpu
+ * @details batches are evaluated one instruction at a time over a whole block of points
+ * so that the inner loops are simple enough for the compiler to vectorize
+ */
+class CpuExpression {
+    struct Instruction {
+        ExpressionOp op;
+        float value;
+    };
+
+    /** points evaluated per instruction in the batched evaluate */
+    static constexpr std::size_t block_size = 256;
+
+    std::vector<Instruction> program;
+    std::size_t max_stack_depth;
+
+    void emit(ExpressionNode const &node, std::size_t depth);
+
+public:
+    CpuExpression() = delete;
+    explicit CpuExpression(ExpressionNode const &node);
+
+    [[nodiscard]] float evaluate(float x, float y) const;
+
+    /**
+     * evaluate the expression at every (xs[i], ys[i]), all spans must be the same length
+     */
+    void evaluate(std::span<const float> xs, std::span<const float> ys, std::span<float> out) const;
+
+    [[nodiscard]] std::size_t instruction_count() const noexcept;
+};
+
+/**
+ * @brief a parsed and optimized user function with its glsl and cpu backends
+ */
+class CompiledExpression {
+    std::string source;
+    ExpressionNode ast;
+    std::string canonical;
+    std::string glsl;
+    CpuExpression cpu;
+    std::size_t hash;
+
+public:
+    /** glsl function name that the vertex / tes stage calls */
+    static constexpr const char *glsl_function_name = "plotted_function";
+
+    CompiledExpression() = delete;
+
+    /**
+     * throws ExpressionError on malformed input or constants out of range of a float
+     */
+    explicit CompiledExpression(std::string_view source);
+
+    [[nodiscard]] std::string const &get_source() const noexcept;
+    [[nodiscard]] ExpressionNode const &get_ast() const noexcept;
+
+    /**
+     * @return canonical text of the optimized expression
+     */
+    [[nodiscard]] std::string const &get_canonical() const noexcept;
+
+    /**
+     * @return glsl source defining float plotted_function(float x, float y)
+     */
+    [[nodiscard]] std::string const &get_glsl() const noexcept;
+
+    [[nodiscard]] CpuExpression const &get_cpu() const noexcept;
+
+    /**
+     * @return hash of the canonical form, used as the shader cache key
+     */
+    [[nodiscard]] std::size_t get_hash() const noexcept;
+};
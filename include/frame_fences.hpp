@@ -0,0 +1,57 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+/**
+ * @brief bounds how many frames the gpu may be behind the cpu using fence syncs
+ * @details with 1 frame in flight the cpu prepares frame N+1 while the gpu draws frame N and waits
+ * for it before submitting, lowest latency. with 2 the cpu can get a whole frame ahead, more
+ * throughput at the cost of a frame of latency. without this the driver decides, often 3 frames
+ */
+class FrameFences {
+    /** ring of fences, one per frame in flight, 0 if the slot is free */
+    std::vector<GLsync> fences;
+    std::size_t next;
+
+    std::shared_ptr<spdlog::logger> logger;
+
+public:
+    static constexpr std::size_t max_frames_in_flight = 2;
+
+    FrameFences() = delete;
+    FrameFences(const FrameFences &) = delete;
+    FrameFences(FrameFences &&) = default;
+    FrameFences &operator=(const FrameFences &) = delete;
+    FrameFences &operator=(FrameFences &&) = default;
+
+    /**
+     * @param frames_in_flight clamped to [1, max_frames_in_flight]
+     */
+    explicit FrameFences(std::size_t frames_in_flight);
+
+    /**
+     * prereq: the context the fences were made in must be current
+     */
+    ~FrameFences();
+
+    /**
+     * blocks until submitting another frame keeps within the frames in flight,
+     * call after the cpu side work of the frame and before its draw calls
+     * @return ns spent waiting on the gpu
+     */
+    uint64_t wait_for_slot();
+
+    /**
+     * mark the end of the frame's gpu commands, call after the swap
+     */
+    void frame_submitted();
+
+    [[nodiscard]] std::size_t get_frames_in_flight() const noexcept;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "frame_time_stats.hpp"
+
+#include <cstdint>
+#include <memory>
+
+#include <SDL3/SDL.h>
+#include <spdlog/spdlog.h>
+
+/**
+ * @brief paces frames to the refresh rate of the display the window is on
+ * @details targets refresh rate / divisor. vsync (adaptive when the driver allows it) paces frames that are
+ * presented. without vsync presented frames sleep most of the way to the deadline and spin for the rest,
+ * since sleeps overshoot by up to a scheduler quantum. frames that are not presented only sleep
+ */
+class FramePacer {
+    uint64_t frame_budget_ns;
+
+    /** SDL_GetTicksNS by which the current frame should be presented */
+    uint64_t deadline_ns;
+
+    /** when the previous frame ended, for stats */
+    uint64_t last_frame_end_ns;
+
+    bool vsync_enabled;
+    bool adaptive_vsync;
+
+    FrameTimeStats stats;
+
+    std::shared_ptr<spdlog::logger> logger;
+
+public:
+    FramePacer() = delete;
+    FramePacer(const FramePacer &) = delete;
+    FramePacer(FramePacer &&) = default;
+    FramePacer &operator=(const FramePacer &) = delete;
+    FramePacer &operator=(FramePacer &&) = default;
+    ~FramePacer() = default;
+
+    /**
+     * prereq: the window must have a current opengl context, the swap interval is set here
+     * @param divisor render every divisor-th display refresh
+     */
+    FramePacer(SDL_Window *window, unsigned int divisor);
+
+    [[nodiscard]] uint64_t get_frame_budget_ns() const noexcept;
+
+    /**
+     * @return SDL_GetTicksNS by which the current frame should be presented
+     */
+    [[nodiscard]] uint64_t get_deadline_ns() const noexcept;
+
+    /**
+     * @return ns left until the deadline, 0 if it has passed
+     */
+    [[nodiscard]] uint64_t remaining_ns() const;
+
+    /**
+     * wait for the end of the current frame and move the deadline to the next one
+     * @param presented was a buffer swapped this frame, if so vsync already waited for the display
+     */
+    void end_frame(bool presented);
+
+    [[nodiscard]] FrameTimeStats const &get_stats() const noexcept;
+
+    [[nodiscard]] bool is_adaptive_vsync() const noexcept;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <format>
+
+/**
+ * @brief running mean / variance of frame times using Welford's algorithm
+ * @details constant memory and numerically stable over long sessions, used to check frame pacing quality
+ */
+class FrameTimeStats {
+    uint64_t count;
+    double mean;
+
+    /** sum of squared differences from the current mean */
+    double m2;
+    uint64_t min;
+    uint64_t max;
+
+public:
+    FrameTimeStats();
+
+    void add(uint64_t frame_time_ns);
+    void reset();
+
+    [[nodiscard]] uint64_t get_count() const noexcept;
+    [[nodiscard]] double get_mean_ns() const noexcept;
+
+    /**
+     * @return sample variance in ns^2, 0 with fewer than two frames
+     */
+    [[nodiscard]] double get_variance_ns2() const noexcept;
+    [[nodiscard]] double get_stddev_ns() const noexcept;
+
+    /**
+     * @return 0 if no frames were added
+     */
+    [[nodiscard]] uint64_t get_min_ns() const noexcept;
+    [[nodiscard]] uint64_t get_max_ns() const noexcept;
+};
+
+template <> struct std::formatter<FrameTimeStats> {
+    template <typename ParseContext> constexpr auto parse(ParseContext &ctx) {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext> auto format(const FrameTimeStats &obj, FormatContext &ctx) const {
+        return std::format_to(ctx.out(),
+                              "< FrameTimeStats frames {0} mean {1:.3f} ms stddev {2:.3f} ms min {3:.3f} ms max "
+                              "{4:.3f} ms >",
+                              obj.get_count(), obj.get_mean_ns() / 1e6, obj.get_stddev_ns() / 1e6,
+                              static_cast<double>(obj.get_min_ns()) / 1e6, static_cast<double>(obj.get_max_ns()) / 1e6);
+    }
+};
@@ -19,4 +19,6 @@ struct FunctionParams {
     FunctionParams(GLfloat x_offset, GLfloat y_offset, GLfloat z_mult)
         : x_offset(x_offset), y_offset(y_offset), z_mult(z_mult) {
     }
+
+    bool operator==(FunctionParams const &rhs) const = default;
 };
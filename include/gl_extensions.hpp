@@ -0,0 +1,61 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include <string_view>
+
+// the bundled glad loader only has core 4.1 / es 3.0, so extension enums and entry points are declared here
+
+/** GL_KHR_parallel_shader_compile / GL_ARB_parallel_shader_compile */
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+/** GL_EXT_disjoint_timer_query, GL_TIME_ELAPSED is core in opengl but not in es 3.0 */
+#ifndef GL_TIME_ELAPSED_EXT
+#define GL_TIME_ELAPSED_EXT 0x88BF
+#endif
+
+#ifndef GL_GPU_DISJOINT_EXT
+#define GL_GPU_DISJOINT_EXT 0x8FBB
+#endif
+
+/**
+ * prereq: must have opengl initialized before calling
+ * @return true if the current context advertises the extension
+ */
+bool has_gl_extension(std::string_view extension_name);
+
+/**
+ * enable driver side parallel shader compilation if available, needs a current context
+ * @return true if GL_COMPLETION_STATUS_KHR can be queried to poll compiles / links without blocking
+ */
+bool init_parallel_shader_compile();
+
+/**
+ * @return the result of init_parallel_shader_compile
+ */
+bool is_parallel_shader_compile_supported();
+
+/**
+ * load GL_EXT_disjoint_timer_query on opengl es, timer queries are core in opengl 4.1. needs a current context
+ * @return true if GL_TIME_ELAPSED queries can be used
+ */
+bool init_gpu_timer_queries();
+
+/**
+ * @return the result of init_gpu_timer_queries
+ */
+bool are_gpu_timer_queries_supported();
+
+/**
+ * glGetQueryObjectui64v, or glGetQueryObjectui64vEXT on opengl es
+ * prereq: are_gpu_timer_queries_supported
+ */
+void get_query_object_ui64v(GLuint query, GLenum pname, GLuint64 *params);
+
+/**
+ * @return true if gpu timings since the last call are unreliable (e.g. the gpu changed clocks), always false
+ * outside of opengl es
+ */
+bool was_gpu_timer_disjoint();
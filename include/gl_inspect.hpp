@@ -1,6 +1,7 @@
 #pragma once
 
 #include "glad/glad.h"
+#include <cstddef>
 #include <optional>
 #include <string>
 
@@ -26,3 +27,10 @@ std::string gl_get_error_string();
  * @return get max tessellation level, or nullopt on unsupported
  */
 std::optional<GLuint> get_max_tessellation_level();
+
+/**
+ * @brief there is no gl query for how many objects exist, this probes every name up to max_name instead
+ * @details drivers hand names out low and in order, so growth between calls points at a leak
+ * @return live buffers, vertex arrays, textures, framebuffers, renderbuffers, queries, shaders and programs
+ */
+std::size_t count_gl_objects(GLuint max_name);
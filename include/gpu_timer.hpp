@@ -0,0 +1,52 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+/**
+ * @brief measures how long the gpu spends on a frame with GL_TIME_ELAPSED queries
+ * @details the queries are double buffered, a result is only read once the driver reports it available
+ * so timing never stalls the pipeline. results arrive a frame or two late and frames whose query is still
+ * pending when its slot comes around again are not timed
+ */
+class GpuTimer {
+    static constexpr std::size_t num_queries = 2;
+
+    std::array<GLuint, num_queries> queries;
+
+    /** slots with a query that has been ended but not read back */
+    std::array<bool, num_queries> pending;
+    std::size_t next;
+    bool running;
+    bool supported;
+
+public:
+    GpuTimer(const GpuTimer &) = delete;
+    GpuTimer(GpuTimer &&) = delete;
+    GpuTimer &operator=(const GpuTimer &) = delete;
+    GpuTimer &operator=(GpuTimer &&) = delete;
+
+    /**
+     * prereq: init_gpu_timer_queries has been called, does nothing if the queries aren't supported
+     */
+    GpuTimer();
+    ~GpuTimer();
+
+    /**
+     * start timing the gpu commands that follow, skipped if the next query slot is still in use
+     */
+    void begin();
+    void end();
+
+    /**
+     * never blocks
+     * @return gpu time of the most recently finished frame, if one finished since the last call
+     */
+    [[nodiscard]] std::optional<uint64_t> collect();
+
+    [[nodiscard]] bool is_supported() const noexcept;
+};
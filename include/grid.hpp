@@ -2,7 +2,6 @@
 
 #include "es/grid_points.hpp"
 #include "shader_program.hpp"
-#include "tick_result.hpp"
 #include "vertices.hpp"
 
 #include <cstdint>
@@ -30,6 +29,19 @@ public:
         : verts(std::move(grid_points)), program(shader_program), show_wireframe_only(false) {
     }
 
+    /**
+     * swap the program used for drawing, e.g. to a different shader variant
+     * the program must already have its uniforms set
+     */
+    void set_program(std::shared_ptr<ShaderProgram> const &shader_program) noexcept;
+
+    [[nodiscard]] bool is_wireframe_only() const noexcept;
+
+    /**
+     * draw only the edges of the mesh (opengl 4.1 only)
+     */
+    void set_wireframe_only(bool wireframe_only);
+
     // NOLINTNEXTLINE(modernize-use-nodiscard)
-    uint64_t render(TickResult tick_result);
+    uint64_t render();
 };
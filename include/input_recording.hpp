@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+/**
+ * the input one EventLoop::process_frame took in, and the clock readings it made
+ */
+struct RecordedTick {
+    /** SDL_GetTicksNS when the tick started */
+    uint64_t start_ns = 0;
+
+    /** what held keys were integrated up to, nullopt if the tick ended before that (skipped or quit) */
+    std::optional<uint64_t> integrated_until_ns;
+
+    /** events in the order they were taken off the queue, a batch per SDL_PeepEvents, before coalescing */
+    std::vector<std::vector<SDL_Event>> batches;
+};
+
+/**
+ * @brief the sdl events EventLoop consumed, tick by tick, for replaying the same input across builds
+ * @details saved in a compact binary format, only the event fields EventLoop and coalescing look at are kept.
+ * values are stored in host byte order, recordings are meant to be replayed on the machine they were made on
+ */
+class InputRecording {
+    /** what EventLoop started integrating held keys from */
+    uint64_t started_at_ns;
+    std::vector<RecordedTick> ticks;
+
+public:
+    InputRecording() = delete;
+
+    explicit InputRecording(uint64_t started_at_ns);
+
+    void begin_tick(uint64_t start_ns);
+
+    /**
+     * prereq: begin_tick
+     */
+    void add_batch(std::span<SDL_Event const> events);
+
+    /**
+     * prereq: begin_tick
+     */
+    void end_tick(std::optional<uint64_t> integrated_until_ns);
+
+    [[nodiscard]] uint64_t get_started_at_ns() const noexcept;
+
+    [[nodiscard]] std::vector<RecordedTick> const &get_ticks() const noexcept;
+
+    void write(std::ostream &out) const;
+
+    /**
+     * @throws InputError if it is not a recording, is cut short or has counts it can't hold
+     */
+    [[nodiscard]] static InputRecording read(std::istream &in);
+
+    /**
+     * @throws InputError if the file can't be written
+     */
+    void save(std::filesystem::path const &path) const;
+
+    /**
+     * @throws InputError if the file can't be read or is not a recording
+     */
+    [[nodiscard]] static InputRecording load(std::filesystem::path const &path);
+};
+
+/**
+ * @brief steps through an InputRecording on a virtual clock, standing in for SDL_GetTicksNS
+ * @details recorded times are moved by a whole number of milliseconds to when the replay started, so
+ * millisecond arithmetic on them comes out the same as it did while recording
+ */
+class InputReplay {
+    std::vector<RecordedTick> ticks;
+    std::size_t next_tick;
+
+    /** added to every recorded time, wraps around when the replay started earlier than the recording */
+    uint64_t offset_ns;
+    uint64_t started_at_ns;
+
+    /** virtual clock, the start of the tick last replayed */
+    uint64_t now_ns;
+
+public:
+    InputReplay() = delete;
+
+    /**
+     * @param start_ns SDL_GetTicksNS when the replay starts
+     */
+    InputReplay(InputRecording const &recording, uint64_t start_ns);
+
+    /**
+     * @return the recording's start on the virtual clock
+     */
+    [[nodiscard]] uint64_t get_started_at_ns() const noexcept;
+
+    [[nodiscard]] uint64_t get_now_ns() const noexcept;
+
+    [[nodiscard]] bool is_finished() const noexcept;
+
+    /**
+     * prereq: !is_finished()
+     * @return when the next tick ended on the virtual clock, to replay at the recorded pace
+     */
+    [[nodiscard]] uint64_t get_next_due_ns() const;
+
+    /**
+     * prereq: !is_finished()
+     * @return the next tick with its times and event timestamps on the virtual clock, which moves to its start
+     */
+    [[nodiscard]] RecordedTick next();
+};
@@ -2,6 +2,7 @@
 
 #include <SDL3/SDL_scancode.h>
 #include <key_mod.hpp>
+#include <key_table.hpp>
 
 #include <SDL3/SDL.h>
 
@@ -19,22 +20,73 @@ template <bool ignore_non_shift = true> struct KeyEquivalentEqualTo;
 
 class Key {
     SDL_Scancode scan_code;
+
+    /** only set when the key came with one, e.g. from an event, otherwise see get_key_code */
     std::optional<SDL_Keycode> key_code;
     KeyMod key_mod;
 
     friend KeyEquivalentHash<>;
     friend KeyEquivalentEqualTo<>;
-    friend bool operator==(const Key &lhs, const Key &rhs);
     friend std::ostream &operator<<(std::ostream &stream, const Key &key);
     friend std::formatter<Key>;
 
+    friend constexpr bool operator==(const Key &lhs, const Key &rhs) {
+        return lhs.scan_code == rhs.scan_code && lhs.key_mod == rhs.key_mod;
+    }
+
+    /**
+     * SDL_GetKeyFromScancode in the live keyboard layout
+     */
+    [[nodiscard]] std::optional<SDL_Keycode> resolve_key_code() const;
+
+    /**
+     * SDL_GetScancodeFromKey in the live keyboard layout
+     */
+    [[nodiscard]] static Key from_live_key_code(SDL_Keycode key_code);
+
+    /**
+     * from the US layout at compile time, the live one at run time
+     */
+    [[nodiscard]] static constexpr Key from_key_code(SDL_Keycode key_code) {
+        if consteval {
+            auto const [scan_code, key_mod] =
+                us_scan_code_from_key(key_code).value_or(std::pair{SDL_SCANCODE_UNKNOWN, SDL_Keymod{SDL_KMOD_NONE}});
+            return Key{scan_code, key_code, key_mod};
+        }
+        else {
+            return from_live_key_code(key_code);
+        }
+    }
+
+    [[nodiscard]] static constexpr Key from_keyish(Keyish const &keyish) {
+        if (auto const *const scan_code = std::get_if<SDL_Scancode>(&keyish)) {
+            return Key{*scan_code};
+        }
+
+        if (auto const *const scan_code_with_mod = std::get_if<std::pair<SDL_Scancode, SDL_Keymod>>(&keyish)) {
+            return Key{*scan_code_with_mod};
+        }
+
+        return from_key_code(std::get<SDL_Keycode>(keyish));
+    }
+
 public:
     Key() = delete;
-    // TODO: deferred sdl_keycode lookup for more constexpr stuff
-    explicit Key(SDL_Scancode scan_code);
-    explicit Key(SDL_Scancode scan_code, SDL_Keymod key_mod);
-    explicit Key(SDL_Scancode scan_code, KeyMod key_mod);
-    explicit Key(std::pair<SDL_Scancode, SDL_Keymod> scan_code_with_mod);
+
+    constexpr explicit Key(SDL_Scancode scan_code) : scan_code(scan_code), key_code(std::nullopt), key_mod() {
+    }
+
+    constexpr explicit Key(SDL_Scancode scan_code, SDL_Keymod key_mod)
+        : scan_code(scan_code), key_code(std::nullopt), key_mod(key_mod) {
+    }
+
+    constexpr explicit Key(SDL_Scancode scan_code, KeyMod key_mod)
+        : scan_code(scan_code), key_code(std::nullopt), key_mod(key_mod) {
+    }
+
+    constexpr explicit Key(std::pair<SDL_Scancode, SDL_Keymod> scan_code_with_mod)
+        : Key(scan_code_with_mod.first, scan_code_with_mod.second) {
+    }
 
     constexpr Key(SDL_Scancode scan_code, SDL_Keycode key_code, SDL_Keymod key_mod)
         : scan_code(scan_code), key_code(key_code), key_mod(key_mod) {
@@ -44,8 +96,14 @@ public:
         : scan_code(scan_code), key_code(key_code), key_mod(key_mod) {
     }
 
-    explicit Key(SDL_Keycode key_code);
-    Key(Keyish const &keyish);
+    /**
+     * the scan code typing the key code in the US layout at compile time, in the live layout at run time
+     */
+    constexpr explicit Key(SDL_Keycode key_code) : Key(from_key_code(key_code)) {
+    }
+
+    constexpr Key(Keyish const &keyish) : Key(from_keyish(keyish)) {
+    }
 
     [[nodiscard]] constexpr SDL_Scancode get_scan_code() const {
         return scan_code;
@@ -56,11 +114,25 @@ public:
     }
 
     [[nodiscard]] constexpr bool has_key_code() const {
-        return key_code.has_value();
+        return get_key_code().has_value();
     }
 
+    /**
+     * the key code the key came with, otherwise what it types: in the US layout at compile time, looked up in the
+     * live layout at run time only when asked for
+     * @return nullopt if the key does not type anything
+     */
     [[nodiscard]] constexpr std::optional<SDL_Keycode> get_key_code() const {
-        return key_code;
+        if (key_code.has_value()) {
+            return key_code;
+        }
+
+        if consteval {
+            return us_key_from_scan_code(scan_code, key_mod.has_shift());
+        }
+        else {
+            return resolve_key_code();
+        }
     }
 
     /**
@@ -110,40 +182,90 @@ public:
         return is_alpha() || is_numeric();
     }
 
-    [[nodiscard]] Key copy_with_mods(SDL_Keymod mods) const;
+    [[nodiscard]] constexpr Key copy_with_mods(SDL_Keymod mods) const {
+        return Key{scan_code, mods};
+    }
 
     /**
      * new copy of this key but with the shift modifier applied
      * (both left and right)
      */
-    [[nodiscard]] Key copy_shifted(bool only_keep_shift = true) const;
+    [[nodiscard]] constexpr Key copy_shifted(bool only_keep_shift = true) const {
+        if (only_keep_shift) {
+            return Key{scan_code, KeyMod::shift()};
+        }
+        else {
+            return Key{scan_code, key_mod.with_shifted()};
+        }
+    }
 
     /**
      * new copy of this key without any modifiers
      */
-    [[nodiscard]] Key without_mods() const;
+    [[nodiscard]] constexpr Key without_mods() const {
+        return Key{scan_code};
+    }
 
     /**
      * new copy of this key without shift modifiers
      */
-    [[nodiscard]] Key without_shift() const;
+    [[nodiscard]] constexpr Key without_shift() const {
+        KeyMod key_mod_copy{key_mod};
+        key_mod_copy.set_shift(false);
+        return Key{scan_code, key_mod_copy};
+    }
 
     /**
      * new copy with normalized scan codes and modifiers
      */
-    [[nodiscard]] Key as_normalized() const;
+    [[nodiscard]] constexpr Key as_normalized() const {
+        auto new_key_mod = key_mod.as_normalized();
+        auto new_scan_code = get_equivalent_scan_code();
+
+        if (new_scan_code == SDL_SCANCODE_LSHIFT) {
+            new_key_mod.set_shift();
+        }
+        else if (new_scan_code == SDL_SCANCODE_LALT) {
+            new_key_mod.set_alt();
+        }
+        else if (new_scan_code == SDL_SCANCODE_LCTRL) {
+            new_key_mod.set_ctrl();
+        }
+
+        return Key{new_scan_code, new_key_mod};
+    }
 
     /**
      * a new copy of this key with the shift modifier
      * if it isn't applied to this, or without it if it
      * already is applied
      */
-    [[nodiscard]] Key shift_mod_complement(bool only_modify_shift = true) const;
+    [[nodiscard]] constexpr Key shift_mod_complement(bool only_modify_shift = true) const {
+        if (only_modify_shift) {
+            return has_shift() ? Key{scan_code} : Key{scan_code, KeyMod::shift()};
+        }
+
+        KeyMod key_mod_copy{key_mod};
+        key_mod_copy.set_shift(!has_shift());
+        return Key{scan_code, key_mod_copy};
+    }
 
     /**
      * account for differences in left and right equivalent keys
      */
-    [[nodiscard]] SDL_Scancode get_equivalent_scan_code() const;
+    [[nodiscard]] constexpr SDL_Scancode get_equivalent_scan_code() const {
+        if (scan_code == SDL_SCANCODE_RSHIFT) {
+            return SDL_SCANCODE_LSHIFT;
+        }
+        else if (scan_code == SDL_SCANCODE_RALT) {
+            return SDL_SCANCODE_LALT;
+        }
+        else if (scan_code == SDL_SCANCODE_RCTRL) {
+            return SDL_SCANCODE_LCTRL;
+        }
+
+        return scan_code;
+    }
 
     [[nodiscard]] static constexpr Key up() {
         return Key{SDL_SCANCODE_UP};
@@ -161,22 +283,62 @@ public:
         return Key{SDL_SCANCODE_RIGHT};
     }
 
-    Key &set_shift(bool bit_val = true);
-    Key &set_alt(bool bit_val = true);
-    Key &set_ctrl(bool bit_val = true);
-    Key &set_lshift(bool bit_val = true);
-    Key &set_rshift(bool bit_val = true);
-    Key &set_lctrl(bool bit_val = true);
-    Key &set_rctrl(bool bit_val = true);
-    Key &set_lalt(bool bit_val = true);
-    Key &set_ralt(bool bit_val = true);
+    // changing shift changes what the key types, it is looked up again when asked for
+    constexpr Key &set_shift(bool bit_val = true) {
+        key_mod.set_shift(bit_val);
+        key_code = std::nullopt;
+        return *this;
+    }
+
+    constexpr Key &set_alt(bool bit_val = true) {
+        key_mod.set_alt(bit_val);
+        return *this;
+    }
+
+    constexpr Key &set_ctrl(bool bit_val = true) {
+        key_mod.set_ctrl(bit_val);
+        return *this;
+    }
+
+    constexpr Key &set_lshift(bool bit_val = true) {
+        key_mod.set_lshift(bit_val);
+        key_code = std::nullopt;
+        return *this;
+    }
+
+    constexpr Key &set_rshift(bool bit_val = true) {
+        key_mod.set_rshift(bit_val);
+        key_code = std::nullopt;
+        return *this;
+    }
+
+    constexpr Key &set_lctrl(bool bit_val = true) {
+        key_mod.set_lctrl(bit_val);
+        return *this;
+    }
+
+    constexpr Key &set_rctrl(bool bit_val = true) {
+        key_mod.set_rctrl(bit_val);
+        return *this;
+    }
+
+    constexpr Key &set_lalt(bool bit_val = true) {
+        key_mod.set_lalt(bit_val);
+        return *this;
+    }
+
+    constexpr Key &set_ralt(bool bit_val = true) {
+        key_mod.set_ralt(bit_val);
+        return *this;
+    }
 };
 
 namespace std {
 template <> struct hash<Key> {
-    std::size_t operator()(const Key &key) const {
-        std::size_t scan_code_hash = std::hash<SDL_Scancode>{}(key.get_scan_code());
-        std::size_t key_mod_hash = std::hash<SDL_Keymod>{}(key.get_key_mod());
+    // std::hash of the scan code and the key mod are the identity, but not constexpr
+    constexpr std::size_t operator()(const Key &key) const {
+        auto const scan_code_hash = static_cast<std::size_t>(key.get_scan_code());
+        auto const key_mod_hash = static_cast<std::size_t>(key.get_key_mod());
         return scan_code_hash ^ (key_mod_hash << 1);
     }
 };
@@ -187,9 +349,9 @@ template <> struct formatter<Key, char> {
     }
 
     template <typename FormatContext> auto format(const Key &obj, FormatContext &ctx) const {
+        auto const key_code = obj.get_key_code().transform([](auto code) { return std::to_string(code); });
         return std::format_to(ctx.out(), "< Key {0} : scan {1} mod {2} key {3} >", SDL_GetScancodeName(obj.scan_code),
-                              std::to_string(obj.scan_code), obj.key_mod,
-                              obj.key_code.transform([](auto code) { return std::to_string(code); }).value_or("n/a"));
+                              std::to_string(obj.scan_code), obj.key_mod, key_code.value_or("n/a"));
     }
 };
 
@@ -200,8 +362,8 @@ template <> struct formatter<Key, char> {
  * scan code and modifiers that were pressed do not matter
  */
 template <bool ignore_non_shift> struct KeyEquivalentHash {
-    size_t operator()(const Key &key) const {
-        std::size_t scan_code_hash = std::hash<SDL_Scancode>{}(key.get_equivalent_scan_code());
+    constexpr size_t operator()(const Key &key) const {
+        auto const scan_code_hash = static_cast<std::size_t>(key.get_equivalent_scan_code());
         std::size_t key_mod_hash = KeyModEquivalentHash<ignore_non_shift>{}(key.key_mod);
         return scan_code_hash ^ (key_mod_hash << 1);
     }
@@ -105,15 +105,41 @@ struct KeyMod {
         return has_lalt() || has_ralt();
     }
 
-    KeyMod &set_shift(bool bit_val = true);
-    KeyMod &set_alt(bool bit_val = true);
-    KeyMod &set_ctrl(bool bit_val = true);
-    KeyMod &set_lshift(bool bit_val = true);
-    KeyMod &set_rshift(bool bit_val = true);
-    KeyMod &set_lctrl(bool bit_val = true);
-    KeyMod &set_rctrl(bool bit_val = true);
-    KeyMod &set_lalt(bool bit_val = true);
-    KeyMod &set_ralt(bool bit_val = true);
+    constexpr KeyMod &set_shift(bool bit_val = true) {
+        return set_lshift(bit_val).set_rshift(bit_val);
+    }
+
+    constexpr KeyMod &set_alt(bool bit_val = true) {
+        return set_lalt(bit_val).set_ralt(bit_val);
+    }
+
+    constexpr KeyMod &set_ctrl(bool bit_val = true) {
+        return set_lctrl(bit_val).set_rctrl(bit_val);
+    }
+
+    constexpr KeyMod &set_lshift(bool bit_val = true) {
+        return set_bits(lshift, bit_val);
+    }
+
+    constexpr KeyMod &set_rshift(bool bit_val = true) {
+        return set_bits(rshift, bit_val);
+    }
+
+    constexpr KeyMod &set_lctrl(bool bit_val = true) {
+        return set_bits(lctrl, bit_val);
+    }
+
+    constexpr KeyMod &set_rctrl(bool bit_val = true) {
+        return set_bits(rctrl, bit_val);
+    }
+
+    constexpr KeyMod &set_lalt(bool bit_val = true) {
+        return set_bits(lalt, bit_val);
+    }
+
+    constexpr KeyMod &set_ralt(bool bit_val = true) {
+        return set_bits(ralt, bit_val);
+    }
 
     /**
      * returns if the two key mods function the same for the
@@ -133,7 +159,23 @@ struct KeyMod {
      * are pressed simultaneously so as to match the results of
      * SDL_GetScancodeFromKey
      */
-    [[nodiscard]] KeyMod as_normalized() const;
+    [[nodiscard]] constexpr KeyMod as_normalized() const {
+        KeyMod copied{*this};
+
+        if (copied.has_ralt() != copied.has_lalt()) {
+            copied.set_alt();
+        }
+
+        if (copied.has_rctrl() != copied.has_lctrl()) {
+            copied.set_ctrl();
+        }
+
+        if (copied.has_rshift() != copied.has_lshift()) {
+            copied.set_shift();
+        }
+
+        return copied;
+    }
 
     /**
      * adds modifiers to this keymod
@@ -169,14 +211,29 @@ private:
 
     std::bitset<CHAR_BIT * sizeof(SDL_Keymod)> val;
 
+    constexpr KeyMod &set_bits(std::bitset<CHAR_BIT * sizeof(SDL_Keymod)> const &bits, bool bit_val) {
+        if (bit_val) {
+            val |= bits;
+        }
+        else {
+            val &= ~bits;
+        }
+
+        return *this;
+    }
+
     friend std::ostream &operator<<(std::ostream &stream, const KeyMod &key);
-    friend bool operator==(const KeyMod &lhs, const KeyMod &rhs);
+
+    friend constexpr bool operator==(const KeyMod &lhs, const KeyMod &rhs) {
+        return lhs.val == rhs.val;
+    }
 };
 
 namespace std {
 template <> struct hash<KeyMod> {
-    std::size_t operator()(const KeyMod &key_mod) const {
-        return std::hash<SDL_Keymod>{}(key_mod);
+    // the same as std::hash<SDL_Keymod>, which is the identity, but constexpr
+    constexpr std::size_t operator()(const KeyMod &key_mod) const {
+        return static_cast<std::size_t>(static_cast<SDL_Keymod>(key_mod));
     }
 };
 
@@ -232,7 +289,7 @@ template <bool ignore_non_shift> struct KeyModEquivalentEqualTo {
  * modifiers that were pressed do not matter
  */
 template <bool ignore_non_shift = true> struct KeyModEquivalentHash {
-    std::size_t operator()(const KeyMod &key_mod) const {
+    constexpr std::size_t operator()(const KeyMod &key_mod) const {
         if (ignore_non_shift) {
             KeyMod copied{key_mod};
             copied.set_ctrl(false).set_alt(false);
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+/**
+ * what the scan codes from SDL_SCANCODE_A to SDL_SCANCODE_SLASH type on a US keyboard, without and with shift.
+ * the key code of a printable key is the character it types, \0 is a key that types nothing (non-US #)
+ */
+inline constexpr char us_unshifted_keys[] = "abcdefghijklmnopqrstuvwxyz"
+                                            "1234567890"
+                                            "\r\x1b\b\t "
+                                            "-=[]\\"
+                                            "\0"
+                                            ";'`,./";
+inline constexpr char us_shifted_keys[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                          "!@#$%^&*()"
+                                          "\r\x1b\b\t "
+                                          "_+{}|"
+                                          "\0"
+                                          ":\"~<>?";
+
+inline constexpr std::size_t num_us_keys = SDL_SCANCODE_SLASH - SDL_SCANCODE_A + 1;
+static_assert(sizeof(us_unshifted_keys) == num_us_keys + 1 && sizeof(us_shifted_keys) == num_us_keys + 1);
+
+/**
+ * the key code a scan code has in the US layout, for when the live layout can not be asked, e.g. at compile time
+ * @return nullopt if the key does not type anything, such as the arrow and modifier keys
+ */
+[[nodiscard]] constexpr std::optional<SDL_Keycode> us_key_from_scan_code(SDL_Scancode scan_code, bool shifted) {
+    if (scan_code < SDL_SCANCODE_A || scan_code > SDL_SCANCODE_SLASH) {
+        return std::nullopt;
+    }
+
+    auto const typed = (shifted ? us_shifted_keys : us_unshifted_keys)[scan_code - SDL_SCANCODE_A];
+    if (typed == '\0') {
+        return std::nullopt;
+    }
+
+    return static_cast<SDL_Keycode>(static_cast<unsigned char>(typed));
+}
+
+/**
+ * the reverse of us_key_from_scan_code, the unshifted key wins for keys typed either way
+ * @return the scan code and SDL_KMOD_SHIFT if shift has to be held to type it, like SDL_GetScancodeFromKey
+ */
+[[nodiscard]] constexpr std::optional<std::pair<SDL_Scancode, SDL_Keymod>> us_scan_code_from_key(SDL_Keycode key_code) {
+    if (key_code == SDLK_UNKNOWN) {
+        return std::nullopt;
+    }
+
+    for (auto const *const keys : {us_unshifted_keys, us_shifted_keys}) {
+        for (std::size_t i = 0; i < num_us_keys; ++i) {
+            if (static_cast<SDL_Keycode>(static_cast<unsigned char>(keys[i])) == key_code) {
+                auto const key_mod = keys == us_shifted_keys ? SDL_KMOD_SHIFT : SDL_KMOD_NONE;
+                return std::pair{static_cast<SDL_Scancode>(SDL_SCANCODE_A + i), static_cast<SDL_Keymod>(key_mod)};
+            }
+        }
+    }
+
+    return std::nullopt;
+}
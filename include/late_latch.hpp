@@ -0,0 +1,32 @@
+#pragma once
+
+#include "render_snapshot.hpp"
+
+#include <cstdint>
+
+#include <glm/mat4x4.hpp>
+
+/**
+ * @brief moves the model of a snapshot on to the moment it is drawn
+ * @details keys held when the snapshot was taken are assumed to still be held, the next snapshot corrects
+ * whatever that got wrong. rotates in the same order as EventLoop, about x then y
+ */
+class LateLatch {
+    /** a stalled input thread should not leave the model spinning */
+    uint64_t max_ahead_ns;
+
+public:
+    LateLatch() = delete;
+    explicit LateLatch(uint64_t max_ahead_ns);
+
+    /**
+     * @param now_ns SDL_GetTicksNS right before drawing
+     * @return the model the snapshot would have had at now_ns
+     */
+    [[nodiscard]] glm::mat4 model_at(RenderSnapshot const &snapshot, uint64_t now_ns) const;
+
+    /**
+     * @return true if the snapshot is still moving once taken, i.e. model_at depends on now_ns
+     */
+    [[nodiscard]] static bool is_moving(RenderSnapshot const &snapshot) noexcept;
+};
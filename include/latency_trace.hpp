@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <string_view>
+#include <vector>
+
+/**
+ * where an input event has got to on its way to the screen, in order
+ */
+enum class LatencyStage : std::uint8_t {
+    /** EventLoop finished the tick that drained it */
+    processed,
+    /** handed to the render thread in a RenderSnapshot */
+    published,
+    /** uniforms written, right before the draw call */
+    uniforms_uploaded,
+    /** draw call returned */
+    submitted,
+    /** SDL_GL_SwapWindow returned */
+    swapped,
+    /** fence after the frame signalled, polled so an upper bound */
+    gpu_complete,
+};
+
+/**
+ * @brief latency from input event timestamps to each LatencyStage, reported as percentiles
+ * @details keeps every sample, only meant for instrumented runs
+ */
+class LatencyTrace {
+public:
+    static constexpr std::size_t num_stages = static_cast<std::size_t>(LatencyStage::gpu_complete) + 1;
+
+private:
+    std::array<std::vector<uint64_t>, num_stages> samples;
+
+public:
+    /**
+     * @param input_ns SDL timestamp of the input event
+     * @param at_ns SDL_GetTicksNS when the event reached the stage, ignored if before input_ns
+     */
+    void add(LatencyStage stage, uint64_t input_ns, uint64_t at_ns);
+
+    [[nodiscard]] std::size_t get_count(LatencyStage stage) const noexcept;
+
+    /**
+     * nearest rank percentile
+     * @param percent in [0, 100]
+     * @return 0 if nothing reached the stage
+     */
+    [[nodiscard]] uint64_t get_percentile_ns(LatencyStage stage, double percent) const;
+
+    [[nodiscard]] static std::string_view get_stage_name(LatencyStage stage) noexcept;
+};
+
+template <> struct std::formatter<LatencyTrace> {
+    template <typename ParseContext> constexpr auto parse(ParseContext &ctx) {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext> auto format(const LatencyTrace &obj, FormatContext &ctx) const {
+        auto out = std::format_to(ctx.out(), "< LatencyTrace");
+        for (std::size_t i = 0; i < LatencyTrace::num_stages; ++i) {
+            auto const stage = static_cast<LatencyStage>(i);
+            out = std::format_to(out, " {0} n {1} p50 {2:.3f} p90 {3:.3f} p99 {4:.3f} max {5:.3f} ms;",
+                                 LatencyTrace::get_stage_name(stage), obj.get_count(stage),
+                                 static_cast<double>(obj.get_percentile_ns(stage, 50.0)) / 1e6,
+                                 static_cast<double>(obj.get_percentile_ns(stage, 90.0)) / 1e6,
+                                 static_cast<double>(obj.get_percentile_ns(stage, 99.0)) / 1e6,
+                                 static_cast<double>(obj.get_percentile_ns(stage, 100.0)) / 1e6);
+        }
+        return std::format_to(out, " >");
+    }
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/spdlog.h>
+
+/**
+ * spdlog throws when registering the same logger name twice, use these for
+ * classes that can have more than one live instance
+ */
+inline std::shared_ptr<spdlog::logger> get_or_create_stdout_logger(std::string const &name) {
+    auto logger = spdlog::get(name);
+    return logger != nullptr ? logger : spdlog::stdout_color_mt(name);
+}
+
+inline std::shared_ptr<spdlog::logger> get_or_create_stderr_logger(std::string const &name) {
+    auto logger = spdlog::get(name);
+    return logger != nullptr ? logger : spdlog::stderr_color_mt(name);
+}
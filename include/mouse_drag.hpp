@@ -0,0 +1,67 @@
+#pragma once
+
+#include "mouse_loc.hpp"
+
+#include <optional>
+
+#include <SDL3/SDL.h>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/vec2.hpp>
+
+/**
+ * how far the mouse moved with a button held since the drag was last applied
+ */
+struct DragDelta {
+    Uint8 button;
+    MouseLoc from;
+    MouseLoc to;
+};
+
+/**
+ * @brief accumulates a mouse drag so it is applied once a tick, however many motion events came in
+ * @details only where the drag was last applied from and where the mouse is now are kept, so a 1000 Hz mouse
+ * costs an assignment per motion event. one button drags at a time
+ */
+class MouseDrag {
+    /** the button dragging, nullopt when there is no drag */
+    std::optional<Uint8> button;
+    MouseLoc from;
+    MouseLoc to;
+
+    /** the button came up, the drag ends once its last movement is taken */
+    bool released;
+
+public:
+    MouseDrag();
+
+    /**
+     * start dragging with the button, ignored while another button is dragging
+     */
+    void press(Uint8 pressed, MouseLoc at);
+
+    /**
+     * ignored when not dragging
+     */
+    void move(MouseLoc at);
+
+    /**
+     * ignored unless it is the button dragging
+     */
+    void release(Uint8 released_button, MouseLoc at);
+
+    /**
+     * @return true while a button is held, or the movement up to its release has not been taken yet
+     */
+    [[nodiscard]] bool is_dragging() const noexcept;
+
+    /**
+     * @return movement since the last call, nullopt if the mouse did not move. ends a released drag
+     */
+    [[nodiscard]] std::optional<DragDelta> take();
+};
+
+/**
+ * shoemake's arcball, the window is the view of a sphere filling its shorter side
+ * @return the rotation in view space taking the point on the sphere under from to the point under to
+ */
+[[nodiscard]] glm::quat arcball_rotation(MouseLoc from, MouseLoc to, glm::vec2 window_size);
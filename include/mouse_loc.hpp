@@ -18,6 +18,10 @@ public:
     MouseLoc(int x, int y) : x((float)x), y((float)y) {
     }
 
+    /** sdl reports mouse positions in fractional window coordinates */
+    MouseLoc(float x, float y) : x(x), y(y) {
+    }
+
     void update_loc() {
         SDL_GetMouseState(&x, &y);
     }
@@ -26,6 +30,10 @@ public:
         return sqrt(pow(x - other.x, 2) + pow(y - other.y, 2));
     }
 
+    glm::vec2 to_vec() const {
+        return glm::vec2(x, y);
+    }
+
     glm::vec2 unit_vec(const MouseLoc &other) const {
         double dist = distance(other);
         return glm::vec2((x - other.x) / dist, (y - other.y) / dist);
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+/** when a key went down and, once it has, when it came back up */
+using Interval = std::pair<uint64_t, std::optional<uint64_t>>;
+
+/**
+ * @brief the last few presses of one key in SDL_GetTicksNS time, oldest overwritten first
+ * @details fixed capacity so recording a press never allocates. a key tapped several times within one
+ * frame keeps every tap as long as there are fewer than capacity of them
+ */
+class PressHistory {
+public:
+    static constexpr std::size_t capacity = 8;
+
+private:
+    /** end_ns of a press that has not been released yet */
+    static constexpr uint64_t still_held = UINT64_MAX;
+
+    struct Press {
+        uint64_t start_ns;
+        uint64_t end_ns;
+    };
+
+    std::array<Press, capacity> presses{};
+
+    /** index of the most recent press */
+    std::size_t last_index = capacity - 1;
+    std::size_t count = 0;
+
+    void push(Press press) noexcept;
+
+public:
+    /**
+     * starts a new press unless the key is already held
+     */
+    void press(uint64_t now_ns) noexcept;
+
+    /**
+     * ends the held press. if the press was never seen one is made up that starts and ends now
+     */
+    void release(uint64_t now_ns) noexcept;
+
+    /**
+     * @return the most recent press, nullopt if the key was never pressed
+     */
+    [[nodiscard]] std::optional<Interval> last() const noexcept;
+
+    /**
+     * @return total nanoseconds the key was down within [start_ns, end_ns], a press that is still held
+     * counts until end_ns
+     */
+    [[nodiscard]] uint64_t held_ns(uint64_t start_ns, uint64_t end_ns) const noexcept;
+
+    [[nodiscard]] bool is_held() const noexcept;
+    [[nodiscard]] std::size_t size() const noexcept;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "glad/glad.h"
+
+/**
+ * @brief tessellation level that drops to a coarse level while interacting and doubles back up to the
+ * target over the idle frames that follow
+ * @details the target is whatever the surface should settle at, it may move in between calls
+ */
+class ProgressiveRefinement {
+    GLuint coarse_level;
+    GLuint level;
+
+public:
+    ProgressiveRefinement() = delete;
+    ProgressiveRefinement(GLuint coarse_level, GLuint initial_level);
+
+    /**
+     * the scene changed, draw it coarse
+     * @return the level to render at, never above target
+     */
+    GLuint coarsen(GLuint target) noexcept;
+
+    /**
+     * one idle frame worth of refinement
+     * @return the level to render at, target once refined
+     */
+    GLuint refine(GLuint target) noexcept;
+
+    /**
+     * skip refinement and render at level from now on
+     * @return level
+     */
+    GLuint set_level(GLuint new_level) noexcept;
+
+    [[nodiscard]] bool is_refined(GLuint target) const noexcept;
+    [[nodiscard]] GLuint get_level() const noexcept;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "quality_governor.hpp"
+
+#include "glad/glad.h"
+
+#include <cstdint>
+#include <optional>
+
+/**
+ * how the frame that was timed was tessellated
+ */
+enum class FrameTessellation : uint8_t {
+    /** not on the gpu, e.g. the es grid, only the resolution is governed */
+    none,
+    /** coarse while the plot is moving, see ProgressiveRefinement */
+    coarse,
+    /** at the governed tessellation level */
+    governed,
+};
+
+/**
+ * @brief splits one frame time budget between the render resolution and the tessellation level
+ * @details under load the resolution is lowered first, tessellation only once the resolution is at its minimum
+ * and frames are still over budget. with headroom again tessellation is raised all the way back to the requested
+ * level before the resolution goes back up
+ */
+class QualityCascade {
+    QualityGovernor resolution;
+    QualityGovernor tessellation;
+
+public:
+    /** what a frame time changed, nullopt for what stayed the same */
+    struct Change {
+        std::optional<GLuint> resolution_step;
+        std::optional<GLuint> tessellation_level;
+    };
+
+    QualityCascade() = delete;
+    QualityCascade(uint64_t frame_budget_ns, GLuint min_resolution_step, GLuint resolution_steps,
+                   GLuint min_tessellation_level, GLuint requested_tessellation_level);
+
+    /**
+     * see QualityGovernor::set_requested_level
+     * @return the tessellation level to render at
+     */
+    GLuint set_requested_tessellation_level(GLuint level);
+
+    /**
+     * @param frame_time_ns how long the last presented frame took to render
+     * @param frame_tessellation coarse frames say nothing about the governed tessellation level
+     */
+    Change add_frame_time(uint64_t frame_time_ns, FrameTessellation frame_tessellation);
+
+    [[nodiscard]] GLuint get_resolution_step() const noexcept;
+    [[nodiscard]] GLuint get_tessellation_level() const noexcept;
+    [[nodiscard]] GLuint get_requested_tessellation_level() const noexcept;
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "max_deque.hpp"
+
+#include "glad/glad.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+/**
+ * @brief closed loop control of a quality level to hold a frame time budget
+ * @details additive increase / multiplicative decrease: when the average frame time goes over the budget the
+ * level is cut by a quarter, when there is plenty of headroom it goes back up one at a time. the gap between
+ * the two thresholds and waiting for a full window of frames after every change keep it from oscillating.
+ * the level the user asked for is always the ceiling
+ */
+class QualityGovernor {
+    uint64_t frame_budget_ns;
+    GLuint min_level;
+    GLuint requested_level;
+    GLuint level;
+
+    /** frame times since the last level change */
+    MaxDeque<uint64_t> frame_times;
+
+    void reset_window();
+
+public:
+    /** lower the level when the average frame time is above this fraction of the budget */
+    static constexpr double lower_above_budget = 0.9;
+
+    /** raise the level when the average frame time is below this fraction of the budget */
+    static constexpr double raise_below_budget = 0.6;
+
+    /** frames to average before deciding, also the cool down after a change */
+    static constexpr std::size_t window_frames = 10;
+
+    QualityGovernor() = delete;
+    QualityGovernor(uint64_t frame_budget_ns, GLuint min_level, GLuint requested_level);
+
+    /**
+     * the user changed the level, it is used as is until frame times say otherwise
+     * @return the level to render at
+     */
+    GLuint set_requested_level(GLuint new_requested_level);
+
+    /**
+     * @param frame_time_ns how long the last presented frame took to render
+     * @return the new level if it changed
+     */
+    std::optional<GLuint> add_frame_time(uint64_t frame_time_ns);
+
+    [[nodiscard]] GLuint get_level() const noexcept;
+    [[nodiscard]] GLuint get_requested_level() const noexcept;
+    [[nodiscard]] GLuint get_min_level() const noexcept;
+};
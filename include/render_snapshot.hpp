@@ -0,0 +1,42 @@
+#pragma once
+
+#include "function_params.hpp"
+#include "glad/glad.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+
+/**
+ * @brief everything the render thread needs to draw a frame, published by the input thread
+ * @details holds absolute state rather than deltas so that snapshots can be skipped
+ */
+struct RenderSnapshot {
+    glm::mat4 model{1.0f};
+    glm::mat4 view{1.0f};
+    glm::mat4 projection{1.0f};
+    FunctionParams function_params;
+    GLuint tessellation_level = 0;
+    bool wireframe_only = false;
+
+    /** index into the plotted functions */
+    std::size_t function_index = 0;
+
+    /** incremented whenever the window system asks for the window to be redrawn */
+    uint64_t redraw_generation = 0;
+
+    /** SDL_GetTicksNS that input has been integrated into model up to */
+    uint64_t sampled_at_ns = 0;
+
+    /** how fast keys still held at sampled_at_ns rotate the model about x and y, see LateLatch */
+    glm::vec2 model_rotation_rads_per_ns{0.0f};
+
+    /** SDL timestamp of the oldest input event behind this snapshot, 0 if none, see LatencyTrace */
+    uint64_t input_timestamp_ns = 0;
+
+    /** SDL_GetTicksNS when the input thread finished processing the input and when it published it */
+    uint64_t input_processed_ns = 0;
+    uint64_t published_ns = 0;
+};
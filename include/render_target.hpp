@@ -0,0 +1,60 @@
+#pragma once
+
+#include "glad/glad.h"
+
+/**
+ * @brief where frames are drawn, an offscreen framebuffer at a fraction of the window resolution
+ * @details the scaled frame is upscaled to the window with a bilinear blit. at full scale the
+ * offscreen framebuffer is skipped and frames are drawn to the window directly, so the blit is
+ * only paid for while the resolution is lowered
+ */
+class RenderTarget {
+    GLuint framebuffer;
+    GLuint color;
+    GLsizei window_width;
+    GLsizei window_height;
+
+    /** size of the color renderbuffer storage, 0 until first needed */
+    GLsizei width;
+    GLsizei height;
+    float scale;
+
+    [[nodiscard]] GLsizei scaled_width() const noexcept;
+    [[nodiscard]] GLsizei scaled_height() const noexcept;
+
+    /**
+     * throws WrappedOpenGLError if the framebuffer can't be rendered to at the new size
+     */
+    void resize();
+
+public:
+    RenderTarget() = delete;
+    RenderTarget(const RenderTarget &) = delete;
+    RenderTarget(RenderTarget &&) = delete;
+    RenderTarget &operator=(const RenderTarget &) = delete;
+    RenderTarget &operator=(RenderTarget &&) = delete;
+
+    /**
+     * prereq: the context must be current
+     */
+    RenderTarget(GLsizei window_width, GLsizei window_height);
+    ~RenderTarget();
+
+    /**
+     * @param new_scale fraction of the window resolution on each axis, clamped to (0, 1]
+     */
+    void set_scale(float new_scale);
+
+    /**
+     * bind the framebuffer and viewport frames should be drawn to
+     */
+    void begin();
+
+    /**
+     * upscale the frame to the window if it was drawn offscreen, call before swapping
+     */
+    void end();
+
+    [[nodiscard]] float get_scale() const noexcept;
+    [[nodiscard]] bool is_scaled() const noexcept;
+};
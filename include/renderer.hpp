@@ -0,0 +1,209 @@
+#pragma once
+
+#include "expression.hpp"
+#include "frame_fences.hpp"
+#include "frame_pacer.hpp"
+#include "frame_time_stats.hpp"
+#include "function_params.hpp"
+#include "gpu_timer.hpp"
+#include "grid.hpp"
+#include "late_latch.hpp"
+#include "latency_trace.hpp"
+#include "max_deque.hpp"
+#include "progressive_refinement.hpp"
+#include "quality_cascade.hpp"
+#include "render_snapshot.hpp"
+#include "render_target.hpp"
+#include "shader_program.hpp"
+#include "shader_variants.hpp"
+#include "shader_watcher.hpp"
+#include "soak_monitor.hpp"
+#include "tessellation_settings.hpp"
+#include "triple_buffer.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glm/mat4x4.hpp>
+#include <spdlog/spdlog.h>
+
+/**
+ * @brief owns the opengl context and draws on its own thread
+ * @details the input thread publishes RenderSnapshots with publish, the render thread picks up the latest
+ * one each frame so neither a blocking swap nor slow input processing holds up the other
+ */
+class Renderer {
+    SDL_Window *window;
+    SDL_GLContext context;
+
+    /** render thread copies of the uniform state, bound to every ShaderProgram */
+    std::shared_ptr<glm::mat4> model;
+    std::shared_ptr<glm::mat4> view;
+    std::shared_ptr<glm::mat4> projection;
+    std::shared_ptr<FunctionParams> function_params;
+    std::shared_ptr<TessellationSettings> tessellation_settings;
+
+    std::vector<CompiledExpression> functions;
+    ShaderVariants shader_variants;
+    ShaderVariantKey variant_key;
+
+    /** variants compiled before they are asked for */
+    std::vector<ShaderVariantKey> ahead_of_time;
+    std::shared_ptr<ShaderProgram> program;
+    Grid grid;
+
+    /** edits under SHADER_OVERRIDE_DIR are recompiled in the background and swapped in once linked */
+    ShaderWatcher shader_watcher;
+    std::shared_ptr<ShaderProgram> reloaded_program;
+    ShaderVariantKey reloaded_key;
+
+    /** shader files changed since the last reload was swapped in */
+    std::vector<std::string> reloaded_sources;
+
+    FramePacer frame_pacer;
+    FrameFences frame_fences;
+
+    /** gpu execution time of presented frames, not cpu submission or swap blocking */
+    GpuTimer gpu_timer;
+    MaxDeque<uint64_t> gpu_timings;
+    FrameTimeStats gpu_time_stats;
+
+    /** frames are drawn here at a lowered resolution when going over budget */
+    RenderTarget render_target;
+
+    /** the render target scale and tessellation level held to the frame budget */
+    QualityCascade quality;
+
+    /** coarse tessellation while the plot is moving, refined up to the governed level once it stops */
+    ProgressiveRefinement refinement;
+
+    /** the model is rotated on to the moment of drawing, after everything else in the frame */
+    LateLatch late_latch;
+
+    /** the model uniform holds an extrapolation rather than the applied snapshot's model */
+    bool model_latched;
+
+    /** only when LATENCY_TRACE is set, input timestamps followed from the input thread to the gpu */
+    std::optional<LatencyTrace> latency_trace;
+
+    /** oldest input applied but not yet presented, 0 if none */
+    uint64_t traced_input_ns;
+
+    /** signalled when the gpu finished the frame that presented fenced_input_ns, 0 if none in flight */
+    GLsync latency_fence;
+    uint64_t fenced_input_ns;
+
+    /** only when SOAK_REPORT_MS is set, frame time drift and resource growth logged every interval */
+    std::optional<SoakMonitor> soak_monitor;
+
+    /** longest to go without presenting a frame when nothing changed, 0 presents every frame */
+    uint64_t keep_alive_ms;
+
+    TripleBuffer<RenderSnapshot> snapshots;
+
+    /** last snapshot drawn */
+    std::optional<RenderSnapshot> applied;
+
+    std::atomic<bool> failed;
+
+    std::shared_ptr<spdlog::logger> logger;
+    std::shared_ptr<spdlog::logger> err;
+
+    /** last so that it is joined before anything it uses is destroyed */
+    std::jthread thread;
+
+    void run(std::stop_token stop_token);
+
+    /**
+     * bring the programs up to date with the snapshot
+     * @return true if what is on screen changed
+     */
+    bool apply(RenderSnapshot const &snapshot);
+
+    void switch_program(ShaderVariantKey key);
+
+    /**
+     * feed the time a presented frame took to render to the quality cascade
+     * @return true if the resolution or tessellation level changed
+     */
+    bool govern_quality(uint64_t frame_time_ns);
+
+    /**
+     * step the tessellation back up towards the governed level after interaction stopped
+     * @return true if the level changed
+     */
+    bool refine();
+
+    void set_tessellation_level(GLuint level);
+
+    /**
+     * pick up a snapshot published while waiting for the gpu and extrapolate the model to now,
+     * the last thing before drawing
+     */
+    void latch();
+
+    void poll_shader_reload();
+
+    /**
+     * no-op unless tracing, or input_ns is 0
+     */
+    void trace_latency(LatencyStage stage, uint64_t input_ns, uint64_t at_ns);
+
+    /**
+     * record gpu completion of the traced frame if its fence signalled, without waiting on it
+     */
+    void poll_latency_fence();
+
+    /**
+     * log how the session has drifted since the first soak interval if another one is over
+     */
+    void report_soak();
+
+public:
+    Renderer() = delete;
+    Renderer(const Renderer &) = delete;
+    Renderer(Renderer &&) = delete;
+    Renderer &operator=(const Renderer &) = delete;
+    Renderer &operator=(Renderer &&) = delete;
+
+    /**
+     * prereq: the context must be current on the calling thread, shaders are submitted for compilation here
+     */
+    Renderer(SDL_Window *window, SDL_GLContext context, std::vector<CompiledExpression> &&functions,
+             ShaderVariantKey initial_variant_key, RenderSnapshot const &initial_snapshot,
+             TessellationSettings const &tessellation_settings, uint64_t keep_alive_ms,
+             unsigned int frame_rate_divisor, std::size_t frames_in_flight, bool trace_input_latency,
+             uint64_t soak_report_interval_ms);
+
+    /**
+     * stops the render thread and makes the context current on the calling thread again
+     */
+    ~Renderer();
+
+    /**
+     * hand the context over to the render thread and start drawing
+     */
+    void start();
+
+    /**
+     * input thread only
+     */
+    void publish(RenderSnapshot const &snapshot);
+
+    /**
+     * @return true if the render thread stopped because of an error, it has already been logged
+     */
+    [[nodiscard]] bool has_failed() const noexcept;
+
+    [[nodiscard]] uint64_t get_frame_budget_ns() const noexcept;
+
+    [[nodiscard]] std::size_t function_count() const noexcept;
+};
@@ -1,26 +1,36 @@
 #pragma once
 
+#include "embedded_shader.hpp"
 #include "glad/glad.h"
 #include "spdlog/logger.h"
 
 #include <filesystem>
 #include <format>
 #include <iostream>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <spdlog/spdlog.h>
 
 class ShaderProgram;
 
 class Shader {
-    static constexpr const GLsizei number_of_sources = 1;   // only supporting 1 source per shader type
-    static constexpr const GLint *source_lengths = nullptr; // can be set to 0 since source ends with a null terminator
+    /**
+     * env var pointing at a directory that takes precedence over the embedded shaders
+     * allows editing shaders without a rebuild
+     */
+    static constexpr const char *override_dir_env_var = "SHADER_OVERRIDE_DIR";
 
     std::shared_ptr<spdlog::logger> logger;
     std::shared_ptr<spdlog::logger> err;
     GLuint shader_handle;
     GLenum shader_type;
 
+    /** compile status is only queried once, on demand, so that compiles can overlap other work */
+    bool compile_checked;
+
     friend std::ostream &operator<<(std::ostream &stream, const Shader &shader);
     friend std::formatter<Shader>;
 
@@ -32,8 +42,42 @@ public:
     Shader(const char *source_fn, GLenum shader_type);
     Shader(const std::string &source_fn, GLenum shader_type);
     Shader(const std::filesystem::path &source_path, GLenum shader_type);
+
+    // the constructors only submit the shader for compilation, see check_compiled
+
+    /**
+     * compile a shader embedded at build time, no file io is done unless
+     * SHADER_OVERRIDE_DIR is set and contains a file with the same relative path
+     */
+    Shader(const EmbeddedShader &embedded_shader, GLenum shader_type);
+
+    /**
+     * compile the sources concatenated in order, only the first may contain a #version directive
+     */
+    Shader(const std::vector<std::string> &sources, GLenum shader_type);
     ~Shader();
 
+    /**
+     * @return the source of the embedded shader, or the file in SHADER_OVERRIDE_DIR that replaces it
+     */
+    [[nodiscard]] static std::string load_source(const EmbeddedShader &embedded_shader);
+
+    /**
+     * @return the SHADER_OVERRIDE_DIR directory, if set
+     */
+    [[nodiscard]] static std::optional<std::filesystem::path> override_dir();
+
+    /**
+     * never blocks
+     * @return false if the driver is still compiling the shader in the background
+     */
+    [[nodiscard]] bool is_compile_complete() const;
+
+    /**
+     * blocks until the compile has finished, throws ShaderCompilationError on failure
+     */
+    void check_compiled();
+
     [[nodiscard]] GLenum get_shader_type() const noexcept;
 
     friend class ShaderProgram;
@@ -13,6 +13,7 @@
 
 #include "function_params.hpp"
 #include "glad/glad.h"
+#include "logging.hpp"
 #include "shader.hpp"
 #include "tessellation_settings.hpp"
 
@@ -36,6 +37,9 @@ class ShaderProgram {
 
     GLuint program_handle;
     bool in_use;
+
+    /** link status is only queried once, on demand, so that linking can overlap other work */
+    bool link_checked;
     std::vector<std::shared_ptr<Shader>> attached_shaders;
 
     std::unordered_map<const GLchar *, GLint> uniform_locations;
@@ -52,6 +56,9 @@ class ShaderProgram {
     void set_uniform_1ui(const GLchar *uniform_variable_name, GLuint value);
     void set_uniform_matrix_4fv(const GLchar *uniform_variable_name, std::shared_ptr<glm::mat4> const &value);
 
+    /**
+     * attach the shaders and submit the link without waiting for it
+     */
     void link_shaders();
 
 public:
@@ -78,16 +85,28 @@ public:
                            std::shared_ptr<glm::mat4> const &projection,
                            std::shared_ptr<FunctionParams> const &function_params,
                            std::shared_ptr<TessellationSettings> const &tessellation_settings)
-        : program_handle(glCreateProgram()), in_use(false),
+        : program_handle(glCreateProgram()), in_use(false), link_checked(false),
           attached_shaders(std::forward<R>(shaders).cbegin(), std::forward<R>(shaders).cend()), model(model),
           view(view), projection(projection), function_params(function_params),
-          tessellation_settings(tessellation_settings), logger(spdlog::stdout_color_mt("shader_program")),
-          err(spdlog::stderr_color_mt("shader_program_err")) {
+          tessellation_settings(tessellation_settings), logger(get_or_create_stdout_logger("shader_program")),
+          err(get_or_create_stderr_logger("shader_program_err")) {
         link_shaders();
     }
 
     ~ShaderProgram();
 
+    /**
+     * never blocks
+     * @return false if the driver is still compiling or linking in the background
+     */
+    [[nodiscard]] bool is_link_complete() const;
+
+    /**
+     * blocks until compiling and linking are done then looks up the uniforms,
+     * throws on compile or link failure. called implicitly by use
+     */
+    void finish_link();
+
     [[nodiscard]] bool is_in_use() const;
     void use();
     void release();
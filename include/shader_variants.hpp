@@ -0,0 +1,200 @@
+#pragma once
+
+#include "expression.hpp"
+#include "function_params.hpp"
+#include "glad/glad.h"
+#include "shader_program.hpp"
+#include "tessellation_settings.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <format>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+#include <spdlog/spdlog.h>
+
+enum class ShaderPrecision : uint8_t {
+    highp = 0,
+    mediump = 1,
+};
+
+enum class FragmentMode : uint8_t {
+    checkerboard = 0,
+    wireframe = 1,
+};
+
+/**
+ * @brief which #define permutation of the shader sources to compile
+ */
+struct ShaderVariantKey {
+    ShaderPrecision precision = ShaderPrecision::highp;
+    FragmentMode fragment_mode = FragmentMode::checkerboard;
+
+    /** CompiledExpression::get_hash of the plotted function */
+    std::size_t function_hash = 0;
+
+    /**
+     * @return the #define part of the key packed into an integer, unique per permutation
+     */
+    [[nodiscard]] constexpr uint32_t packed() const {
+        return static_cast<uint32_t>(precision) | (static_cast<uint32_t>(fragment_mode) << 8U);
+    }
+
+    [[nodiscard]] constexpr ShaderVariantKey with_fragment_mode(FragmentMode mode) const {
+        return ShaderVariantKey{precision, mode, function_hash};
+    }
+
+    [[nodiscard]] constexpr ShaderVariantKey with_function_hash(std::size_t hash) const {
+        return ShaderVariantKey{precision, fragment_mode, hash};
+    }
+
+    /**
+     * @return the #define lines to insert after the #version directive
+     */
+    [[nodiscard]] std::string to_defines() const;
+
+    constexpr bool operator==(const ShaderVariantKey &rhs) const {
+        return packed() == rhs.packed() && function_hash == rhs.function_hash;
+    }
+};
+
+template <> struct std::hash<ShaderVariantKey> {
+    std::size_t operator()(const ShaderVariantKey &key) const {
+        return std::hash<uint32_t>{}(key.packed()) ^ (key.function_hash << 1U);
+    }
+};
+
+template <> struct std::formatter<ShaderVariantKey> {
+    template <typename ParseContext> constexpr auto parse(ParseContext &ctx) {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext> auto format(const ShaderVariantKey &obj, FormatContext &ctx) const {
+        return std::format_to(ctx.out(), "< ShaderVariantKey {0} {1} function {2:x} >",
+                              obj.precision == ShaderPrecision::highp ? "highp" : "mediump",
+                              obj.fragment_mode == FragmentMode::checkerboard ? "checkerboard" : "wireframe",
+                              obj.function_hash);
+    }
+};
+
+/**
+ * @brief lazily compiled cache of shader programs, one per ShaderVariantKey
+ * @details all variants share the same uniform state, so after switching to a different
+ * variant set_initial_uniforms must be called on it before drawing.
+ * programs for the most recently used plotted functions are kept, older ones are evicted
+ */
+class ShaderVariants {
+    /** how many distinct plotted functions to keep compiled programs for */
+    static constexpr std::size_t max_cached_functions = 8;
+
+    std::unordered_map<ShaderVariantKey, std::shared_ptr<ShaderProgram>> programs;
+
+    /** keys waiting to be compiled ahead of time, see compile_next_pending */
+    std::deque<ShaderVariantKey> pending;
+
+    /** glsl of every registered plotted function by hash */
+    std::unordered_map<std::size_t, std::string> function_sources;
+
+    /** most recently used function hashes first */
+    std::deque<std::size_t> recent_functions;
+
+    std::shared_ptr<glm::mat4> model;
+    std::shared_ptr<glm::mat4> view;
+    std::shared_ptr<glm::mat4> projection;
+    std::shared_ptr<FunctionParams> function_params;
+    std::shared_ptr<TessellationSettings> tessellation_settings;
+
+    std::shared_ptr<spdlog::logger> logger;
+
+    [[nodiscard]] std::shared_ptr<ShaderProgram> compile(ShaderVariantKey key) const;
+
+    /**
+     * mark the function as recently used, evicting the programs of the least recently used function
+     */
+    void touch_function(std::size_t function_hash);
+
+public:
+    ShaderVariants() = delete;
+    ShaderVariants(const ShaderVariants &) = delete;
+    ShaderVariants(ShaderVariants &&) = default;
+    ShaderVariants &operator=(const ShaderVariants &) = delete;
+    ShaderVariants &operator=(ShaderVariants &&) = default;
+    ~ShaderVariants() = default;
+
+    /**
+     * prereq: must have opengl initialized before calling
+     */
+    ShaderVariants(std::shared_ptr<glm::mat4> const &model, std::shared_ptr<glm::mat4> const &view,
+                   std::shared_ptr<glm::mat4> const &projection,
+                   std::shared_ptr<FunctionParams> const &function_params,
+                   std::shared_ptr<TessellationSettings> const &tessellation_settings);
+
+    /**
+     * make a plotted function available to the variants, keyed by its hash
+     */
+    void add_function(CompiledExpression const &function);
+
+    /**
+     * @return the program for the key, submitting it for compilation now if it has not been yet.
+     * the program may still be compiling, its first use blocks until it is done
+     */
+    [[nodiscard]] std::shared_ptr<ShaderProgram> get(ShaderVariantKey key);
+
+    /**
+     * submit a fresh compile of the variant from the current shader sources, e.g. after they changed on disk.
+     * the cache is left alone so the result can be checked before it is swapped in with replace
+     */
+    [[nodiscard]] std::shared_ptr<ShaderProgram> recompile(ShaderVariantKey key) const;
+
+    /**
+     * cache the program for the key and drop the other variants built from any of the changed sources,
+     * they were compiled from older versions of them
+     * @param changed_sources shader names like EmbeddedShader::name, e.g. es/vertex.glsl
+     */
+    void replace(ShaderVariantKey key, std::shared_ptr<ShaderProgram> const &program,
+                 std::span<std::string const> changed_sources);
+
+    /**
+     * @return true if the variant has been submitted for compilation
+     */
+    [[nodiscard]] bool is_compiled(ShaderVariantKey key) const;
+
+    /**
+     * never blocks
+     * @return true if the variant can be used without waiting on the driver
+     */
+    [[nodiscard]] bool is_ready(ShaderVariantKey key) const;
+
+    /**
+     * queue up variants to be compiled ahead of time. with parallel shader compile support they are
+     * submitted right away, otherwise they are compiled one at a time by compile_next_pending
+     */
+    void queue(std::vector<ShaderVariantKey> const &keys);
+
+    /**
+     * compile at most one queued variant, intended to be called with spare time in a frame
+     * @return true if a variant was compiled
+     */
+    bool compile_next_pending();
+
+    [[nodiscard]] std::size_t pending_count() const noexcept;
+
+    /**
+     * @param shader_names like EmbeddedShader::name, e.g. es/vertex.glsl
+     * @return true if any of the shaders is a source of the variants. every variant is built from the same
+     * sources, es/ ones are only used by opengl es and the tessellation stages only by desktop opengl
+     */
+    [[nodiscard]] static bool is_built_from(std::span<std::string const> shader_names);
+
+    /**
+     * @return every #define permutation of the plotted function
+     */
+    [[nodiscard]] static std::vector<ShaderVariantKey> all_keys(std::size_t function_hash);
+};
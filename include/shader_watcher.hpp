@@ -0,0 +1,48 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+/**
+ * @brief watches a shader directory (and its subdirectories) for modified .glsl files
+ * @details uses a non blocking inotify descriptor so it can be polled once per frame,
+ * on platforms without inotify nothing is ever reported as changed
+ */
+class ShaderWatcher {
+    /** -1 when not watching anything */
+    int inotify_fd;
+
+    /** inotify watch descriptor to the watched directory relative to the shader directory */
+    std::unordered_map<int, std::filesystem::path> watched_dirs;
+
+    std::shared_ptr<spdlog::logger> logger;
+    std::shared_ptr<spdlog::logger> err;
+
+public:
+    ShaderWatcher() = delete;
+    ShaderWatcher(const ShaderWatcher &) = delete;
+    ShaderWatcher(ShaderWatcher &&) = delete;
+    ShaderWatcher &operator=(const ShaderWatcher &) = delete;
+    ShaderWatcher &operator=(ShaderWatcher &&) = delete;
+
+    /**
+     * @param shader_dir directory to watch, nothing is watched if empty
+     */
+    explicit ShaderWatcher(std::optional<std::filesystem::path> const &shader_dir);
+    ~ShaderWatcher();
+
+    [[nodiscard]] bool is_watching() const noexcept;
+
+    /**
+     * never blocks, all changes since the last call are coalesced into one
+     * @return every shader file written, created, moved or deleted since the last call, relative to the
+     * shader directory like EmbeddedShader::name, e.g. es/vertex.glsl
+     */
+    [[nodiscard]] std::vector<std::string> poll_changed();
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "frame_time_stats.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <optional>
+
+/**
+ * what was measured over one SoakMonitor interval
+ */
+struct SoakSample {
+    /** presented frame to presented frame over the interval */
+    FrameTimeStats frame_times;
+
+    /** resident set size at the end of the interval, nullopt where it can't be read */
+    std::optional<uint64_t> resident_bytes;
+
+    /** live gl object names at the end of the interval, see count_gl_objects */
+    std::size_t gl_objects = 0;
+};
+
+/**
+ * @brief tracks frame times, memory and gl objects over a long session in fixed intervals
+ * @details the first interval is the baseline, every later one is compared against it so slow drift in
+ * frame times and leaks show up as growth
+ */
+class SoakMonitor {
+    uint64_t interval_ns;
+    uint64_t interval_start_ns;
+    uint64_t num_intervals;
+
+    FrameTimeStats frame_times;
+    std::optional<SoakSample> baseline;
+    std::optional<SoakSample> latest;
+
+public:
+    SoakMonitor() = delete;
+
+    /**
+     * @param start_ns SDL_GetTicksNS when the first interval starts
+     */
+    SoakMonitor(uint64_t interval_ns, uint64_t start_ns);
+
+    void add_frame_time(uint64_t frame_time_ns);
+
+    [[nodiscard]] bool is_interval_over(uint64_t now_ns) const noexcept;
+
+    /**
+     * finish the current interval with what was measured at its end and start the next one
+     */
+    void end_interval(uint64_t now_ns, std::optional<uint64_t> resident_bytes, std::size_t gl_objects);
+
+    [[nodiscard]] uint64_t get_interval_count() const noexcept;
+
+    /**
+     * @return the first interval, nullopt before it ended
+     */
+    [[nodiscard]] std::optional<SoakSample> const &get_baseline() const noexcept;
+
+    /**
+     * @return the last interval to end, nullopt before the first one did
+     */
+    [[nodiscard]] std::optional<SoakSample> const &get_latest() const noexcept;
+
+    /**
+     * @return mean frame time of the latest interval less the baseline's, 0 before any interval ended
+     */
+    [[nodiscard]] double get_frame_time_drift_ns() const noexcept;
+
+    /**
+     * @return resident bytes at the end of the latest interval less the baseline's, 0 if unknown
+     */
+    [[nodiscard]] int64_t get_memory_growth_bytes() const noexcept;
+
+    /**
+     * @return gl objects at the end of the latest interval less the baseline's
+     */
+    [[nodiscard]] int64_t get_gl_object_growth() const noexcept;
+
+    /**
+     * reads /proc/self/statm
+     * @return resident set size of this process, nullopt if not on linux or it can't be read
+     */
+    [[nodiscard]] static std::optional<uint64_t> read_resident_bytes();
+};
+
+template <> struct std::formatter<SoakMonitor> {
+    template <typename ParseContext> constexpr auto parse(ParseContext &ctx) {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext> auto format(const SoakMonitor &obj, FormatContext &ctx) const {
+        if (!obj.get_latest().has_value()) {
+            return std::format_to(ctx.out(), "< SoakMonitor no intervals >");
+        }
+
+        auto const &latest = obj.get_latest().value();
+        return std::format_to(ctx.out(),
+                              "< SoakMonitor interval {0} frame time mean {1:.3f} ms max {2:.3f} ms drift {3:+.3f} ms "
+                              "resident {4} KiB growth {5:+} KiB gl objects {6} growth {7:+} >",
+                              obj.get_interval_count(), latest.frame_times.get_mean_ns() / 1e6,
+                              static_cast<double>(latest.frame_times.get_max_ns()) / 1e6,
+                              obj.get_frame_time_drift_ns() / 1e6, latest.resident_bytes.value_or(0) / 1024,
+                              obj.get_memory_growth_bytes() / 1024, latest.gl_objects, obj.get_gl_object_growth());
+    }
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+/**
+ * @brief floods the sdl event queue with seeded random key, wheel and mouse events, then quits
+ * @details for soak testing the input path under load, e.g. thousands of events a second for hours. the same
+ * seed gives the same events. keys are only released after being pressed and everything held is let go
+ * before quitting
+ */
+class StressInput {
+public:
+    /** keys pressed at random, everything EventLoop acts on other than quitting */
+    static constexpr std::size_t num_keys = 12;
+
+private:
+    uint64_t events_per_second;
+    uint64_t duration_ns;
+
+    std::mt19937_64 rng;
+
+    /** by index into the pressed keys */
+    std::bitset<num_keys> held;
+    bool button_held;
+    float mouse_x;
+    float mouse_y;
+
+    /** last so that it is joined before anything it uses is destroyed */
+    std::jthread thread;
+
+    /**
+     * @return in [0, bound)
+     */
+    [[nodiscard]] uint64_t draw(uint64_t bound);
+
+    [[nodiscard]] SDL_Event next_key_event(uint64_t timestamp_ns);
+    [[nodiscard]] SDL_Event next_mouse_event(uint64_t timestamp_ns);
+
+    void run(std::stop_token stop_token);
+
+public:
+    StressInput() = delete;
+    StressInput(const StressInput &) = delete;
+    StressInput(StressInput &&) = delete;
+    StressInput &operator=(const StressInput &) = delete;
+    StressInput &operator=(StressInput &&) = delete;
+
+    /**
+     * @param events_per_second at least 1
+     * @param duration_ns how long to keep going before quitting
+     */
+    StressInput(uint64_t events_per_second, uint64_t duration_ns, uint64_t seed);
+
+    /**
+     * @return the next random event, stamped with timestamp_ns
+     */
+    [[nodiscard]] SDL_Event next_event(uint64_t timestamp_ns);
+
+    /**
+     * @return key ups and a button up for everything still held, which is then no longer held
+     */
+    [[nodiscard]] std::vector<SDL_Event> release_all(uint64_t timestamp_ns);
+
+    /**
+     * start pushing events from now, stops early when destroyed
+     */
+    void start();
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stop_token>
+#include <thread>
+
+#include <SDL3/SDL.h>
+
+/**
+ * @brief pushes a fixed stream of key presses into the sdl event queue, then a quit
+ * @details for measuring input latency without anyone at the keyboard, e.g. headless in ci. events are
+ * pushed from a thread of their own at the time they are timestamped with, the way a real keyboard would
+ */
+class SyntheticInput {
+    std::size_t num_presses;
+    uint64_t press_interval_ns;
+    uint64_t hold_ns;
+
+    /** last so that it is joined before anything it uses is destroyed */
+    std::jthread thread;
+
+    void run(std::stop_token stop_token, uint64_t start_ns) const;
+
+public:
+    SyntheticInput() = delete;
+    SyntheticInput(const SyntheticInput &) = delete;
+    SyntheticInput(SyntheticInput &&) = delete;
+    SyntheticInput &operator=(const SyntheticInput &) = delete;
+    SyntheticInput &operator=(SyntheticInput &&) = delete;
+
+    /**
+     * @param press_interval_ns from one press to the next
+     * @param hold_ns how long each key stays down, less than press_interval_ns
+     */
+    SyntheticInput(std::size_t num_presses, uint64_t press_interval_ns, uint64_t hold_ns);
+
+    /**
+     * @return the number of events in the stream, a press and a release per key press and the quit
+     */
+    [[nodiscard]] std::size_t get_event_count() const noexcept;
+
+    /**
+     * @param index < get_event_count()
+     * @param start_ns when the stream started
+     * @return the event, timestamped with when it is due
+     */
+    [[nodiscard]] SDL_Event get_event(std::size_t index, uint64_t start_ns) const;
+
+    /**
+     * start pushing events from now, stops early when destroyed
+     */
+    void start();
+};
@@ -17,9 +17,11 @@ class TickResult {
     static constexpr const std::size_t model_modified_bit = 4;
     static constexpr const std::size_t view_modified_bit = 5;
     static constexpr const std::size_t tessellation_settings_modified_bit = 6;
+    static constexpr const std::size_t cycle_plotted_function_bit = 7;
+    static constexpr const std::size_t redraw_requested_bit = 8;
 
     // TODO: better mechanism for tracking this
-    std::bitset<tessellation_settings_modified_bit + 1> state;
+    std::bitset<redraw_requested_bit + 1> state;
 
 public:
     // NOLINTNEXTLINE(cppcoreguidelines-non-private-member-variables-in-classes)
@@ -55,6 +57,15 @@ public:
     /** during this tick were the tessellation settings updated? */
     [[nodiscard]] bool tessellation_settings_modified() const noexcept;
 
+    /** during this tick did the user switch to the next plotted function */
+    [[nodiscard]] bool plotted_function_cycled() const noexcept;
+
+    /** did the window system ask for the window contents to be redrawn, e.g. after being exposed */
+    [[nodiscard]] bool redraw_requested() const noexcept;
+
+    /** did anything happen this tick that changes what is on screen */
+    [[nodiscard]] bool needs_redraw() const noexcept;
+
     // setters
     void set_should_exit(bool should_exit=true) noexcept;
     void set_frame_skip(bool should_exit=true) noexcept;
@@ -63,4 +74,6 @@ public:
     void set_model_modified(bool model_modfied=true) noexcept;
     void set_view_modified(bool view_modified=true) noexcept;
     void set_tessellation_settings_modified(bool tessellation_settings_modified=true) noexcept;
+    void set_plotted_function_cycled(bool plotted_function_cycled=true) noexcept;
+    void set_redraw_requested(bool redraw_requested=true) noexcept;
 };
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief lock free single producer / single consumer handoff of the latest value
+ * @details the writer fills the back buffer and publishes it by swapping it with the middle buffer,
+ * the reader picks up the middle buffer only when something new was published. neither side ever
+ * waits on the other and the reader always sees a complete value, intermediate values may be skipped
+ */
+template <typename T>
+    requires std::is_default_constructible_v<T> && std::is_copy_assignable_v<T>
+class TripleBuffer {
+    static constexpr uint8_t index_mask = 0b011;
+
+    /** set on the middle index when it holds a value the reader has not picked up yet */
+    static constexpr uint8_t fresh_bit = 0b100;
+
+    std::array<T, 3> buffers;
+
+    /** index of the buffer in the middle, shared between the threads */
+    std::atomic<uint8_t> middle;
+
+    /** only touched by the writer */
+    uint8_t back;
+
+    /** only touched by the reader */
+    uint8_t front;
+
+public:
+    TripleBuffer() : middle(1), back(0), front(2) {
+    }
+
+    explicit TripleBuffer(T const &initial) : TripleBuffer() {
+        buffers.fill(initial);
+    }
+
+    /**
+     * writer only
+     */
+    void publish(T const &value) {
+        buffers[back] = value;
+        back = middle.exchange(back | fresh_bit, std::memory_order_acq_rel) & index_mask;
+    }
+
+    /**
+     * reader only, picks up the latest published value if there is one
+     * @return true if read() changed
+     */
+    bool update() {
+        if ((middle.load(std::memory_order_relaxed) & fresh_bit) == 0) {
+            return false;
+        }
+
+        front = middle.exchange(front, std::memory_order_acq_rel) & index_mask;
+        return true;
+    }
+
+    /**
+     * reader only
+     * @return the value as of the last update
+     */
+    [[nodiscard]] T const &read() const {
+        return buffers[front];
+    }
+};
@@ -0,0 +1,19 @@
+// shared helpers, compiled after the variant preamble and before the stage source
+
+// ref: https://gist.github.com/companje/29408948f1e8be54dd5733a74ca49bb9
+float map(float value, float min1, float max1, float min2, float max2) {
+    return min2 + (value - min1) * (max2 - min2) / (max1 - min1);
+}
+
+const float eps = 0.00001;
+float skip_zero(float x) {
+    if (x > eps || x < -eps) {
+        return x;
+    }
+    else if (x >= 0.0) {
+        return eps;
+    }
+    else {
+        return -eps;
+    }
+}
@@ -1,5 +1,3 @@
-#version 410 core
-
 layout (vertices=4) out;
 out vec4 vertex_color[];
 uniform uint u_tess_level;
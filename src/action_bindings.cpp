@@ -0,0 +1,246 @@
+#include "action_bindings.hpp"
+#include "active_keys.hpp"
+#include "exceptions.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+using std::nullopt;
+using std::optional;
+using std::size_t;
+using std::span;
+using std::string;
+using std::string_view;
+
+/** the controls in the readme, + being shift and = */
+static constexpr const std::array<Binding, 18> default_bindings = {
+    Binding{Action::pan_x_positive, SDL_SCANCODE_RIGHT, false},
+    Binding{Action::pan_x_negative, SDL_SCANCODE_LEFT, false},
+    Binding{Action::pan_y_positive, SDL_SCANCODE_RIGHT, true},
+    Binding{Action::pan_y_negative, SDL_SCANCODE_LEFT, true},
+    Binding{Action::z_mult_up, SDL_SCANCODE_UP, false},
+    Binding{Action::z_mult_down, SDL_SCANCODE_DOWN, false},
+    Binding{Action::orbit_up, SDL_SCANCODE_W, false},
+    Binding{Action::orbit_down, SDL_SCANCODE_S, false},
+    Binding{Action::orbit_left, SDL_SCANCODE_A, false},
+    Binding{Action::orbit_right, SDL_SCANCODE_D, false},
+    Binding{Action::slow_orbit_up, SDL_SCANCODE_W, true},
+    Binding{Action::slow_orbit_down, SDL_SCANCODE_S, true},
+    Binding{Action::slow_orbit_left, SDL_SCANCODE_A, true},
+    Binding{Action::slow_orbit_right, SDL_SCANCODE_D, true},
+    Binding{Action::tessellation_up, SDL_SCANCODE_EQUALS, true},
+    Binding{Action::tessellation_down, SDL_SCANCODE_MINUS, false},
+    Binding{Action::toggle_wireframe, SDL_SCANCODE_E, false},
+    Binding{Action::next_function, SDL_SCANCODE_F, false},
+};
+
+static constexpr const string_view shift_prefix = "shift+";
+
+namespace {
+string_view trim(string_view text) {
+    auto const start = text.find_first_not_of(" \t\r");
+    if (start == string_view::npos) {
+        return {};
+    }
+
+    return text.substr(start, text.find_last_not_of(" \t\r") - start + 1);
+}
+
+bool starts_with_ignoring_case(string_view text, string_view prefix) {
+    auto const lower = [](char c) { return std::tolower(static_cast<unsigned char>(c)); };
+    return text.size() >= prefix.size() &&
+           std::ranges::equal(text.substr(0, prefix.size()), prefix, std::ranges::equal_to{}, lower, lower);
+}
+
+optional<Action> action_named(string_view name) {
+    for (size_t i = 0; i < ActionBindings::num_actions; ++i) {
+        auto const action = static_cast<Action>(i);
+        if (ActionBindings::get_action_name(action) == name) {
+            return action;
+        }
+    }
+
+    return nullopt;
+}
+
+/**
+ * @throws InputError on anything other than `action = [shift+]key`
+ */
+Binding parse_binding(string_view line, size_t line_number) {
+    auto const equals = line.find('=');
+    if (equals == string_view::npos) {
+        throw InputError(std::format("key bindings line {}: expected action = key", line_number));
+    }
+
+    auto const action_name = ::trim(line.substr(0, equals));
+    auto const action = ::action_named(action_name);
+    if (!action.has_value()) {
+        throw InputError(std::format("key bindings line {0}: unknown action \"{1}\"", line_number, action_name));
+    }
+
+    auto key_name = ::trim(line.substr(equals + 1));
+    bool const shifted = ::starts_with_ignoring_case(key_name, shift_prefix);
+    if (shifted) {
+        key_name = ::trim(key_name.substr(shift_prefix.size()));
+    }
+
+    // SDL_GetScancodeFromName needs a terminated string
+    auto const scan_code = SDL_GetScancodeFromName(string{key_name}.c_str());
+    if (scan_code == SDL_SCANCODE_UNKNOWN) {
+        throw InputError(std::format("key bindings line {0}: unknown key \"{1}\"", line_number, key_name));
+    }
+
+    return Binding{*action, scan_code, shifted};
+}
+} // namespace
+
+ActionBindings::ActionBindings(span<Binding const> bindings) : bindings(bindings.begin(), bindings.end()) {
+    slots.fill(unbound);
+
+    for (auto const &binding : bindings) {
+        auto const scan_code = static_cast<size_t>(binding.scan_code);
+        if (scan_code >= SDL_SCANCODE_COUNT) {
+            throw InputError(std::format("can not bind scan code {}", scan_code));
+        }
+
+        auto &slot = slots[scan_code * variants_per_scan_code + (binding.shifted ? 1 : 0)];
+        if (slot != unbound) {
+            throw InputError(std::format("{0}{1} is bound to both {2} and {3}", binding.shifted ? "shift+" : "",
+                                         SDL_GetScancodeName(binding.scan_code),
+                                         get_action_name(static_cast<Action>(slot)),
+                                         get_action_name(binding.action)));
+        }
+        slot = static_cast<uint8_t>(binding.action);
+
+        if (std::ranges::find(scan_codes, binding.scan_code) == scan_codes.end()) {
+            scan_codes.push_back(binding.scan_code);
+        }
+    }
+
+    // unless shift does something else, it does the same
+    for (auto const scan_code : scan_codes) {
+        auto const index = static_cast<size_t>(scan_code) * variants_per_scan_code;
+        if (slots[index + 1] == unbound) {
+            slots[index + 1] = slots[index];
+        }
+    }
+}
+
+ActionBindings ActionBindings::defaults() {
+    return ActionBindings{default_bindings};
+}
+
+ActionBindings ActionBindings::parse(std::istream &in) {
+    std::vector<Binding> parsed;
+    string line;
+    for (size_t line_number = 1; std::getline(in, line); ++line_number) {
+        auto const trimmed = ::trim(line);
+        if (trimmed.empty() || trimmed.front() == '#') {
+            continue;
+        }
+
+        parsed.push_back(::parse_binding(trimmed, line_number));
+    }
+
+    return ActionBindings{parsed};
+}
+
+ActionBindings ActionBindings::load(std::filesystem::path const &path) {
+    std::ifstream in{path};
+    if (!in) {
+        throw InputError(std::format("could not open key bindings {}", path.string()));
+    }
+
+    return parse(in);
+}
+
+optional<Action> ActionBindings::lookup(SDL_Scancode scan_code, bool shifted) const noexcept {
+    auto const index = static_cast<size_t>(scan_code);
+    if (index >= SDL_SCANCODE_COUNT) {
+        return nullopt;
+    }
+
+    auto const slot = slots[index * variants_per_scan_code + (shifted ? 1 : 0)];
+    return slot == unbound ? nullopt : optional{static_cast<Action>(slot)};
+}
+
+span<Binding const> ActionBindings::get_bindings() const noexcept {
+    return bindings;
+}
+
+span<SDL_Scancode const> ActionBindings::get_scan_codes() const noexcept {
+    return scan_codes;
+}
+
+ActionBindings::ActionDurations ActionBindings::held_ns(span<HeldDuration const> held) const noexcept {
+    ActionDurations durations{};
+    for (size_t i = 0; i < std::min(held.size(), scan_codes.size()); ++i) {
+        auto const index = static_cast<size_t>(scan_codes[i]) * variants_per_scan_code;
+        if (auto const unshifted = slots[index]; unshifted != unbound) {
+            durations[unshifted] += held[i].unshifted_ns;
+        }
+        if (auto const shifted = slots[index + 1]; shifted != unbound) {
+            durations[shifted] += held[i].shifted_ns;
+        }
+    }
+
+    return durations;
+}
+
+string_view ActionBindings::get_action_name(Action action) noexcept {
+    switch (action) {
+    case Action::pan_x_positive:
+        return "pan_x_positive";
+    case Action::pan_x_negative:
+        return "pan_x_negative";
+    case Action::pan_y_positive:
+        return "pan_y_positive";
+    case Action::pan_y_negative:
+        return "pan_y_negative";
+    case Action::z_mult_up:
+        return "z_mult_up";
+    case Action::z_mult_down:
+        return "z_mult_down";
+    case Action::orbit_up:
+        return "orbit_up";
+    case Action::orbit_down:
+        return "orbit_down";
+    case Action::orbit_left:
+        return "orbit_left";
+    case Action::orbit_right:
+        return "orbit_right";
+    case Action::slow_orbit_up:
+        return "slow_orbit_up";
+    case Action::slow_orbit_down:
+        return "slow_orbit_down";
+    case Action::slow_orbit_left:
+        return "slow_orbit_left";
+    case Action::slow_orbit_right:
+        return "slow_orbit_right";
+    case Action::tessellation_up:
+        return "tessellation_up";
+    case Action::tessellation_down:
+        return "tessellation_down";
+    case Action::toggle_wireframe:
+        return "toggle_wireframe";
+    case Action::next_function:
+        return "next_function";
+    }
+
+    return "unknown";
+}
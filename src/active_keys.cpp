@@ -3,7 +3,9 @@
 
 #include <SDL3/SDL.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <expected>
 #include <initializer_list>
@@ -22,36 +24,58 @@ using std::make_tuple;
 using std::nullopt;
 using std::optional;
 using std::pair;
+using std::size_t;
 using std::span;
 using std::string;
 using std::unexpected;
 using std::vector;
 
-ActiveKeys::ActiveKeys(initializer_list<Key> keys_to_monitor) {
+namespace {
+constexpr uint64_t ns_per_ms = 1'000'000;
+
+/**
+ * the millisecond queries see the same times SDL_GetTicks would have returned
+ */
+KeyValue to_ms(KeyValue const &interval_ns) {
+    return interval_ns.transform([](Interval const &interval) {
+        return Interval{interval.first / ns_per_ms,
+                        interval.second.transform([](uint64_t end_ns) { return end_ns / ns_per_ms; })};
+    });
+}
+
+KeyValue last_ms(PressHistory const *history) {
+    return history == nullptr ? nullopt : ::to_ms(history->last());
+}
+} // namespace
+
+ActiveKeys::ActiveKeys() : slots(no_slots) {
+}
+
+ActiveKeys::ActiveKeys(initializer_list<Key> keys_to_monitor) : ActiveKeys() {
     for (auto const key : keys_to_monitor) {
         start_listen_to_key(key);
     }
 }
 
-ActiveKeys::ActiveKeys(initializer_list<SDL_Scancode> scan_codes) {
+ActiveKeys::ActiveKeys(initializer_list<SDL_Scancode> scan_codes) : ActiveKeys() {
     for (auto const scan_code : scan_codes) {
         start_listen_to_key(Key{scan_code});
     }
 }
 
-ActiveKeys::ActiveKeys(initializer_list<pair<SDL_Scancode, SDL_Keymod>> scan_codes_with_mods) {
+ActiveKeys::ActiveKeys(initializer_list<pair<SDL_Scancode, SDL_Keymod>> scan_codes_with_mods) : ActiveKeys() {
     for (auto const scan_code_with_mods : scan_codes_with_mods) {
         start_listen_to_key(Key{scan_code_with_mods});
     }
 }
 
-ActiveKeys::ActiveKeys(initializer_list<SDL_Keycode> key_codes) {
+ActiveKeys::ActiveKeys(initializer_list<SDL_Keycode> key_codes) : ActiveKeys() {
     for (auto const key_code : key_codes) {
         start_listen_to_key(Key{key_code});
     }
 }
 
-ActiveKeys::ActiveKeys(initializer_list<Keyish> keys_to_monitor) {
+ActiveKeys::ActiveKeys(initializer_list<Keyish> keys_to_monitor) : ActiveKeys() {
     for (auto const keyish : keys_to_monitor) {
         start_listen_to_key(Key{keyish});
     }
@@ -71,79 +95,107 @@ void ActiveKeys::start_listen_to_key(const Key &key) {
         return;
     }
 
-    key_timings.insert({key, nullopt});
-    registered_scan_codes.insert(key.get_scan_code());
+    register_key(key);
 
     if (!key.has_modifier() && key.is_alpha()) {
-        key_timings.insert({key.copy_shifted(), nullopt});
+        register_key(key.copy_shifted());
     }
 }
 
-void ActiveKeys::press_key(const Key &key) {
-    if (!registered_scan_codes.contains(key.get_scan_code())) {
+void ActiveKeys::register_key(const Key &key) {
+    if (auto const index = slot_index(key); index.has_value()) {
+        if (slots[*index] == unregistered) {
+            slots[*index] = static_cast<uint16_t>(histories.size());
+            histories.emplace_back();
+        }
         return;
     }
 
-    auto const now_ms = SDL_GetTicks();
-    _press_key(key.without_shift(), now_ms);
+    if (find_history(key) == nullptr) {
+        modded_keys.emplace_back(key, PressHistory{});
+    }
+}
+
+PressHistory *ActiveKeys::find_history(const Key &key) {
+    return const_cast<PressHistory *>(std::as_const(*this).find_history(key));
+}
 
-    if (key.has_shift()) {
-        _press_key(key, now_ms);
+PressHistory const *ActiveKeys::find_history(const Key &key) const {
+    if (auto const index = slot_index(key); index.has_value()) {
+        return slot_history(*index);
     }
 
-    if (!key.has_shift()) {
-        auto const with_shift = key.copy_shifted();
-        if (is_key_registered(with_shift) && key_timings[with_shift].has_value() &&
-            !key_timings[with_shift]->second.has_value()) {
-            _release_key(with_shift, now_ms);
-        }
+    auto const found = std::ranges::find_if(modded_keys, [&](auto const &entry) {
+        return KeyEquivalentEqualTo<>{}(std::get<0>(entry), key);
+    });
+    return found == modded_keys.end() ? nullptr : &std::get<1>(*found);
+}
+
+PressHistory const *ActiveKeys::slot_history(size_t index) const {
+    auto const history_index = slots[index];
+    return history_index == unregistered ? nullptr : &histories[history_index];
+}
+
+bool ActiveKeys::is_scan_code_registered(SDL_Scancode scan_code) const {
+    auto const index = static_cast<size_t>(Key{scan_code, KeyMod::none()}.get_equivalent_scan_code());
+    if (index < SDL_SCANCODE_COUNT && (slots[index * variants_per_scan_code] != unregistered ||
+                                       slots[index * variants_per_scan_code + 1] != unregistered)) {
+        return true;
     }
+
+    return std::ranges::any_of(modded_keys, [&](auto const &entry) {
+        return std::get<0>(entry).get_equivalent_scan_code() == static_cast<SDL_Scancode>(index);
+    });
 }
 
-void ActiveKeys::_press_key(const Key &key, uint64_t now_ms) {
-    if (!is_key_registered(key)) {
+void ActiveKeys::press_key(const Key &key) {
+    press_key(key, SDL_GetTicksNS());
+}
+
+void ActiveKeys::press_key(const Key &key, uint64_t timestamp_ns) {
+    if (!is_scan_code_registered(key.get_scan_code())) {
         return;
     }
 
-    auto const key_timing = key_timings[key];
-    if (!key_timing.has_value()) {
-        // this is the first time the key has ever been pressed
-        key_timings[key] = make_optional(make_pair(now_ms, nullopt));
+    _press_key(key.without_shift(), timestamp_ns);
+
+    if (key.has_shift()) {
+        _press_key(key, timestamp_ns);
     }
-    else {
-        // if this key has been previously released, clear out the old
-        // entry and start a new keypress from this time
-        if (std::get<1>(*key_timing).has_value()) {
-            key_timings[key]->first = now_ms;
-            key_timings[key]->second = nullopt;
+
+    if (!key.has_shift()) {
+        auto const with_shift = key.copy_shifted();
+        auto const *const with_shift_history = find_history(with_shift);
+        if (with_shift_history != nullptr && with_shift_history->is_held()) {
+            _release_key(with_shift, timestamp_ns);
         }
     }
 }
 
-void ActiveKeys::release_key(const Key &key) {
-    if (!registered_scan_codes.contains(key.get_scan_code())) {
-        return;
+void ActiveKeys::_press_key(const Key &key, uint64_t now_ns) {
+    auto *const history = find_history(key);
+    if (history != nullptr) {
+        history->press(now_ns);
     }
+}
 
-    auto const now_ms = SDL_GetTicks();
-    _release_key(key, now_ms);
-    _release_key(key.shift_mod_complement(), now_ms);
+void ActiveKeys::release_key(const Key &key) {
+    release_key(key, SDL_GetTicksNS());
 }
 
-void ActiveKeys::_release_key(const Key &key, uint64_t now_ms) {
-    if (!is_key_registered(key)) {
+void ActiveKeys::release_key(const Key &key, uint64_t timestamp_ns) {
+    if (!is_scan_code_registered(key.get_scan_code())) {
         return;
     }
 
-    auto const key_timing = key_timings[key];
-    if (key_timing.has_value()) {
-        if (!std::get<1>(*key_timing).has_value()) {
-            key_timings[key]->second = make_optional(now_ms);
-        }
-    }
-    else {
-        // original key press has been lost, make up key press start
-        key_timings[key] = make_pair(now_ms, make_optional(now_ms));
+    _release_key(key, timestamp_ns);
+    _release_key(key.shift_mod_complement(), timestamp_ns);
+}
+
+void ActiveKeys::_release_key(const Key &key, uint64_t now_ns) {
+    auto *const history = find_history(key);
+    if (history != nullptr) {
+        history->release(now_ns);
     }
 }
 
@@ -154,8 +206,7 @@ void ActiveKeys::sync_key_state() {
     // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
     span s{key_states, key_states + num_keys};
 
-    for (auto const entry : key_timings) {
-        auto const key = std::get<0>(entry);
+    for (auto const key : get_monitored_keys()) {
         auto const scan_code = key.get_scan_code();
         if (s[static_cast<size_t>(scan_code)]) {
             press_key(key);
@@ -167,12 +218,12 @@ void ActiveKeys::sync_key_state() {
 }
 
 bool ActiveKeys::was_key_pressed_since(const Key &key, uint64_t start_ms) const {
-    if (!is_key_registered(key)) {
+    auto const *const history = find_history(key);
+    if (history == nullptr) {
         return false;
     }
 
-    auto const key_timing = key_timings.at(key);
-    return key_timing
+    return ::to_ms(history->last())
         .transform([start_ms](auto key_timing) {
             return std::get<1>(key_timing)
                 .transform(
@@ -196,54 +247,118 @@ bool ActiveKeys::was_key_pressed_since(SDL_Keycode key_code, uint64_t start_ms)
            (!key.has_shift() && was_key_pressed_since(key.shift_mod_complement(), start_ms));
 }
 
+bool ActiveKeys::is_key_held(const Key &key) const {
+    auto const *const history = find_history(key);
+    return history != nullptr && history->is_held();
+}
+
 KeySet ActiveKeys::get_monitored_keys() const {
     KeySet keys;
-    auto keys_only = key_timings | std::views::transform([](auto entry) { return std::get<0>(entry); });
-#if __cpp_lib_containers_ranges
-    keys.insert_range(keys_only);
-#else
-    for (auto key : keys_only) {
-        keys.insert(key);
+    for (size_t index = 0; index < slots.size(); ++index) {
+        if (slots[index] == unregistered) {
+            continue;
+        }
+
+        auto const scan_code = static_cast<SDL_Scancode>(index / variants_per_scan_code);
+        auto const shifted = index % variants_per_scan_code == 1;
+        keys.insert(Key{scan_code, shifted ? KeyMod::shift() : KeyMod::none()});
+    }
+
+    for (auto const &entry : modded_keys) {
+        keys.insert(std::get<0>(entry));
     }
-#endif
 
     return keys;
 }
 
 [[nodiscard]] bool ActiveKeys::is_key_registered(Key const &key) const {
-    return key_timings.contains(key);
+    return find_history(key) != nullptr;
 }
 
 optional<KeyAtTime> ActiveKeys::which_key_variant_was_pressed_since(uint64_t start_ms, uint64_t end_ms,
                                                                     SDL_Scancode scan_code) const {
-    return which_key_variant_was_pressed_since(start_ms, end_ms, Key{scan_code});
+    return which_key_variant_was_pressed_since(start_ms, end_ms, Key{scan_code, KeyMod::none()});
 }
 
 optional<KeyAtTime> ActiveKeys::which_key_variant_was_pressed_since(uint64_t start_ms, uint64_t end_ms,
                                                                     const Key &key) const {
-    using std::get;
-
-    if (!registered_scan_codes.contains(key.get_scan_code())) {
+    if (!is_scan_code_registered(key.get_scan_code())) {
         return nullopt;
     }
 
-    const Key with_shift = key.copy_shifted();
-    const Key without_shift = key.without_mods();
-    auto const maybe_unshifted_key = registered_key_or_empty(without_shift);
-    auto const maybe_shifted_key = registered_key_or_empty(with_shift);
+    auto const scan_code = key.get_scan_code();
+    auto const *const unshifted_history = find_history(Key{scan_code, KeyMod::none()});
+    auto const *const shifted_history = find_history(Key{scan_code, KeyMod::shift()});
+
+    return which_variant_was_pressed_since(start_ms, end_ms, scan_code, ::last_ms(unshifted_history),
+                                           ::last_ms(shifted_history));
+}
+
+void ActiveKeys::which_key_variants_were_pressed_since(uint64_t start_ms, uint64_t end_ms,
+                                                       span<SDL_Scancode const> scan_codes,
+                                                       span<optional<KeyAtTime>> results) const {
+    assert(scan_codes.size() == results.size());
 
-    auto const maybe_unshifted_key_timing = maybe_unshifted_key.and_then([&](auto key) { return key_timings.at(key); });
-    auto const maybe_shifted_key_timing = maybe_shifted_key.and_then([&](auto key) { return key_timings.at(key); });
+    for (size_t i = 0; i < scan_codes.size(); ++i) {
+        auto const scan_code = static_cast<size_t>(scan_codes[i]);
+        if (scan_code >= SDL_SCANCODE_COUNT) {
+            results[i] = nullopt;
+            continue;
+        }
+
+        auto const *const unshifted = slot_history(scan_code * variants_per_scan_code);
+        auto const *const shifted = slot_history(scan_code * variants_per_scan_code + 1);
+        results[i] = which_variant_was_pressed_since(start_ms, end_ms, scan_codes[i], ::last_ms(unshifted),
+                                                     ::last_ms(shifted));
+    }
+}
 
-    if (!maybe_unshifted_key_timing.has_value() && !maybe_shifted_key_timing.has_value()) {
+HeldDuration ActiveKeys::held_duration(uint64_t start_ns, uint64_t end_ns, SDL_Scancode scan_code) const {
+    HeldDuration result;
+    held_durations(start_ns, end_ns, span{&scan_code, 1}, span{&result, 1});
+    return result;
+}
+
+void ActiveKeys::held_durations(uint64_t start_ns, uint64_t end_ns, span<SDL_Scancode const> scan_codes,
+                                span<HeldDuration> results) const {
+    assert(scan_codes.size() == results.size());
+
+    for (size_t i = 0; i < scan_codes.size(); ++i) {
+        auto const scan_code = static_cast<size_t>(scan_codes[i]);
+        if (scan_code >= SDL_SCANCODE_COUNT) {
+            results[i] = HeldDuration{};
+            continue;
+        }
+
+        auto const *const unshifted = slot_history(scan_code * variants_per_scan_code);
+        auto const *const shifted = slot_history(scan_code * variants_per_scan_code + 1);
+        auto const any_ns = unshifted == nullptr ? 0 : unshifted->held_ns(start_ns, end_ns);
+        auto const shifted_ns = shifted == nullptr ? 0 : shifted->held_ns(start_ns, end_ns);
+
+        // pressing the shifted key presses the unshifted one too, so the shifted time is a part of it
+        results[i] = HeldDuration{any_ns - std::min(any_ns, shifted_ns), shifted_ns};
+    }
+}
+
+optional<KeyAtTime> ActiveKeys::which_variant_was_pressed_since(uint64_t start_ms, uint64_t end_ms,
+                                                                SDL_Scancode scan_code,
+                                                                KeyValue const &unshifted_timing,
+                                                                KeyValue const &shifted_timing) {
+    using std::get;
+
+    if (!unshifted_timing.has_value() && !shifted_timing.has_value()) {
         return nullopt;
     }
 
+    // the keys are only made for the variant returned
+    auto const with_shift = [scan_code]() { return Key{scan_code, KeyMod::shift()}; };
+    auto const without_shift = [scan_code]() { return Key{scan_code}; };
+
     // xor
-    if (maybe_unshifted_key_timing.has_value() != maybe_shifted_key_timing.has_value()) {
+    if (unshifted_timing.has_value() != shifted_timing.has_value()) {
 
-        if (maybe_shifted_key_timing.has_value()) {
-            auto const shift_key_timing = *maybe_shifted_key_timing;
+        if (shifted_timing.has_value()) {
+            auto const shift_key_timing = *shifted_timing;
             auto const maybe_shift_key_end_ms = get<1>(shift_key_timing);
             auto const start_time_ms = std::max(get<0>(shift_key_timing), start_ms);
 
@@ -253,10 +368,10 @@ optional<KeyAtTime> ActiveKeys::which_key_variant_was_pressed_since(uint64_t sta
             }
 
             // button is still held down
-            return make_optional(make_tuple(with_shift, start_time_ms, maybe_shift_key_end_ms.value_or(end_ms)));
+            return make_optional(make_tuple(with_shift(), start_time_ms, maybe_shift_key_end_ms.value_or(end_ms)));
         }
         else {
-            auto const this_key_timing = *maybe_unshifted_key_timing;
+            auto const this_key_timing = *unshifted_timing;
             auto const maybe_shift_key_end_ms = get<1>(this_key_timing);
             auto const start_time_ms = std::max(get<0>(this_key_timing), start_ms);
 
@@ -266,15 +381,15 @@ optional<KeyAtTime> ActiveKeys::which_key_variant_was_pressed_since(uint64_t sta
             }
 
             // button is still held down
-            return make_optional(make_tuple(without_shift, start_time_ms, maybe_shift_key_end_ms.value_or(end_ms)));
+            return make_optional(make_tuple(without_shift(), start_time_ms, maybe_shift_key_end_ms.value_or(end_ms)));
         }
     }
 
-    auto const shift_key_timing = *maybe_shifted_key_timing;
+    auto const shift_key_timing = *shifted_timing;
     auto const shifted_start_time_ms = std::max(get<0>(shift_key_timing), start_ms);
     auto const maybe_shift_key_end_time_ms = get<1>(shift_key_timing);
 
-    auto const this_key_timing = *maybe_unshifted_key_timing;
+    auto const this_key_timing = *unshifted_timing;
     auto const unshifted_start_time_ms = std::max(get<0>(this_key_timing), start_ms);
     auto const maybe_unshifted_key_end_time_ms = get<1>(this_key_timing);
 
@@ -287,39 +402,30 @@ optional<KeyAtTime> ActiveKeys::which_key_variant_was_pressed_since(uint64_t sta
     // if either was left go of in the past then choose the other one
     if (maybe_shift_key_end_time_ms.has_value() && *maybe_shift_key_end_time_ms < start_ms) {
         return make_optional(
-            make_tuple(without_shift, unshifted_start_time_ms, maybe_unshifted_key_end_time_ms.value_or(end_ms)));
+            make_tuple(without_shift(), unshifted_start_time_ms, maybe_unshifted_key_end_time_ms.value_or(end_ms)));
     }
 
     if (maybe_unshifted_key_end_time_ms.has_value() && *maybe_unshifted_key_end_time_ms < start_ms) {
         return make_optional(
-            make_tuple(with_shift, shifted_start_time_ms, maybe_shift_key_end_time_ms.value_or(end_ms)));
+            make_tuple(with_shift(), shifted_start_time_ms, maybe_shift_key_end_time_ms.value_or(end_ms)));
     }
 
     // tie-breaker if both keys were pressed
     // arbitrary: give shift key precedence if either are still
     // held down at the end of the frame
     if (!maybe_shift_key_end_time_ms.has_value() && !maybe_unshifted_key_end_time_ms.has_value()) {
-        return make_optional(make_tuple(with_shift, shifted_start_time_ms, end_ms));
+        return make_optional(make_tuple(with_shift(), shifted_start_time_ms, end_ms));
     }
     else {
-        return make_optional(make_tuple(without_shift, unshifted_start_time_ms, end_ms));
-    }
-
-    return nullopt;
-}
-
-optional<Key> ActiveKeys::registered_key_or_empty(const Key &key) const {
-    if (is_key_registered(key)) {
-        return make_optional(key);
+        return make_optional(make_tuple(without_shift(), unshifted_start_time_ms, end_ms));
     }
-
-    return nullopt;
 }
 
 expected<KeyValue, string> ActiveKeys::get(const Key &key) const {
-    if (!is_key_registered(key)) {
+    auto const *const history = find_history(key);
+    if (history == nullptr) {
         return unexpected(std::format("key {0} not registered", key));
     }
 
-    return key_timings.at(key);
+    return ::to_ms(history->last());
 }
@@ -0,0 +1,88 @@
+#include "event_coalescer.hpp"
+
+#include <bitset>
+#include <cstddef>
+#include <optional>
+#include <span>
+
+#include <SDL3/SDL.h>
+
+using std::nullopt;
+using std::optional;
+using std::size_t;
+using std::span;
+
+namespace {
+bool same_wheel(SDL_MouseWheelEvent const &a, SDL_MouseWheelEvent const &b) {
+    return a.windowID == b.windowID && a.which == b.which && a.direction == b.direction;
+}
+
+bool same_motion(SDL_MouseMotionEvent const &a, SDL_MouseMotionEvent const &b) {
+    return a.windowID == b.windowID && a.which == b.which && a.state == b.state;
+}
+
+void merge_wheel(SDL_MouseWheelEvent &into, SDL_MouseWheelEvent const &from) {
+    into.timestamp = from.timestamp;
+    into.x += from.x;
+    into.y += from.y;
+    into.integer_x += from.integer_x;
+    into.integer_y += from.integer_y;
+    into.mouse_x = from.mouse_x;
+    into.mouse_y = from.mouse_y;
+}
+
+void merge_motion(SDL_MouseMotionEvent &into, SDL_MouseMotionEvent const &from) {
+    into.timestamp = from.timestamp;
+    into.x = from.x;
+    into.y = from.y;
+    into.xrel += from.xrel;
+    into.yrel += from.yrel;
+}
+} // namespace
+
+size_t coalesce_events(span<SDL_Event> events) {
+    size_t kept = 0;
+
+    // where the current run of each kind of event is being merged into
+    optional<size_t> wheel = nullopt;
+    optional<size_t> motion = nullopt;
+    std::bitset<SDL_SCANCODE_COUNT> repeated;
+
+    for (auto const &event : events) {
+        if (event.type == SDL_EVENT_MOUSE_WHEEL) {
+            if (wheel.has_value() && ::same_wheel(events[*wheel].wheel, event.wheel)) {
+                ::merge_wheel(events[*wheel].wheel, event.wheel);
+                continue;
+            }
+
+            wheel = kept;
+        }
+        else if (event.type == SDL_EVENT_MOUSE_MOTION) {
+            if (motion.has_value() && ::same_motion(events[*motion].motion, event.motion)) {
+                ::merge_motion(events[*motion].motion, event.motion);
+                continue;
+            }
+
+            motion = kept;
+        }
+        else if (event.type == SDL_EVENT_KEY_DOWN && event.key.repeat &&
+                 static_cast<size_t>(event.key.scancode) < repeated.size()) {
+            // the key is already held, one repeat says as much as many
+            auto const scan_code = static_cast<size_t>(event.key.scancode);
+            if (repeated.test(scan_code)) {
+                continue;
+            }
+
+            repeated.set(scan_code);
+        }
+        else {
+            wheel = nullopt;
+            motion = nullopt;
+            repeated.reset();
+        }
+
+        events[kept++] = event;
+    }
+
+    return kept;
+}
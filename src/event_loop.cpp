@@ -1,19 +1,29 @@
 #include "event_loop.hpp"
+#include "action_bindings.hpp"
 #include "active_keys.hpp"
 #include "consts.hpp"
+#include "event_coalescer.hpp"
 #include "function_params.hpp"
+#include "input_recording.hpp"
 #include "key.hpp"
+#include "key_mod.hpp"
+#include "mouse_drag.hpp"
+#include "mouse_loc.hpp"
 #include "tessellation_settings.hpp"
 #include "tick_result.hpp"
 
+#include <algorithm>
 #include <array>
+#include <bitset>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <memory>
 #include <numbers>
 #include <optional>
+#include <span>
 #include <tuple>
+#include <utility>
 
 #include <SDL3/SDL.h>
 #include <glm/ext/matrix_transform.hpp>
@@ -33,6 +43,7 @@ using std::nullopt;
 using std::optional;
 using std::shared_ptr;
 using std::size_t;
+using std::span;
 using std::tuple;
 using std::numbers::pi_v;
 
@@ -66,7 +77,6 @@ static const constexpr vec3 y_axis = vec3(0.0f, 1.0f, 0.0f);
  * how much to zoom per scroll wheel click / notch? (whatever that is called)
  */
 static const constexpr float zoom_amount_scroll_wheel = 0.5f;
-static const constexpr vec3 zoom_out = vec3(0.0f, 0.0f, -zoom_amount_scroll_wheel);
 static const constexpr vec3 zoom_in = vec3(0.0f, 0.0f, zoom_amount_scroll_wheel);
 
 /**
@@ -75,6 +85,12 @@ static const constexpr vec3 zoom_in = vec3(0.0f, 0.0f, zoom_amount_scroll_wheel)
  */
 static const constexpr GLfloat panning_delta_per_ms = 0.0005f;
 
+/** how much dragging with the right button pans the 3d function, a window height is one unit */
+static const constexpr GLfloat panning_delta_per_px = 1.0f / static_cast<GLfloat>(window_h);
+
+/** the arcball fills the shorter side of the window */
+static const constexpr glm::vec2 window_size{static_cast<float>(window_w), static_cast<float>(window_h)};
+
 /**
  * how much to change the 3d function z mult per frame
  * NOTE: manually tuned
@@ -89,11 +105,8 @@ static const constexpr uint64_t msec_between_tess_level_changes = 700;
  * (opengl 4.1 only) */
 static const constexpr uint64_t msec_between_toggle_wireframe_changes = 400;
 
-static const constexpr array monitored_keys = {
-    Keyish{SDL_SCANCODE_W},  Keyish{SDL_SCANCODE_A},    Keyish{SDL_SCANCODE_S},    Keyish{SDL_SCANCODE_D},
-    Keyish{SDL_SCANCODE_UP}, Keyish{SDL_SCANCODE_DOWN}, Keyish{SDL_SCANCODE_LEFT}, Keyish{SDL_SCANCODE_RIGHT},
-    Keyish{SDLK_PLUS},       Keyish{SDLK_MINUS},        Keyish{SDL_SCANCODE_E},
-};
+/** how long in msec between switching to the next plotted function */
+static const constexpr uint64_t msec_between_plotted_function_changes = 400;
 
 /**
  * the number of event timings to hold on to
@@ -102,75 +115,96 @@ static const constexpr array monitored_keys = {
  */
 constexpr size_t num_event_timings_maintain = 10;
 
+/** SDL_WaitEventTimeout only has millisecond resolution */
+constexpr uint64_t ns_per_ms = 1'000'000;
+
 EventLoop::EventLoop(shared_ptr<mat4> const &model, shared_ptr<mat4> const &view, shared_ptr<mat4> const &projection,
                      shared_ptr<FunctionParams> const &function_params,
-                     shared_ptr<TessellationSettings> const &tessellation_settings)
-    : model(model), view(view), projection(projection), function_params(function_params), start_click(nullopt),
-      event_poll_timings(num_event_timings_maintain), active_keys(ActiveKeys{monitored_keys}),
-      tessellation_settings(tessellation_settings), last_tessellation_change_at_msec(nullopt),
-      last_wireframe_only_change_at_msec(nullopt), logger(spdlog::stdout_color_mt("event_loop")),
-      err(spdlog::stderr_color_mt("event_loop_err")) {
+                     shared_ptr<TessellationSettings> const &tessellation_settings, ActionBindings action_bindings)
+    : model(model), view(view), projection(projection), function_params(function_params),
+      event_poll_timings(num_event_timings_maintain), action_bindings(std::move(action_bindings)),
+      active_keys(ActiveKeys{this->action_bindings.get_scan_codes()}),
+      held_keys(this->action_bindings.get_scan_codes().size()), held_actions_ns{},
+      tessellation_settings(tessellation_settings), integrated_until_ns(SDL_GetTicksNS()),
+      model_rotation_rads_per_ns(0.0f), oldest_input_ns(0), last_tessellation_change_at_msec(nullopt),
+      last_wireframe_only_change_at_msec(nullopt), last_plotted_function_change_at_msec(nullopt),
+      logger(spdlog::stdout_color_mt("event_loop")), err(spdlog::stderr_color_mt("event_loop_err")) {
 }
 
-TickResult EventLoop::process_function_mutation_keys(uint64_t start_ticks_ms, TickResult tick_result) {
-    using std::get;
-
-    auto const now_ms = SDL_GetTicks();
-    auto const up_key_timing = active_keys.which_key_variant_was_pressed_since(start_ticks_ms, now_ms, Key::up());
-    auto const down_key_timing = active_keys.which_key_variant_was_pressed_since(start_ticks_ms, now_ms, Key::down());
-
-    auto const left_key_timing = active_keys.which_key_variant_was_pressed_since(start_ticks_ms, now_ms, Key::left());
-    auto const right_key_timing = active_keys.which_key_variant_was_pressed_since(start_ticks_ms, now_ms, Key::right());
+namespace {
+/**
+ * keys held against each other cancel out for as long as both were down
+ * @return positive_ns - negative_ns in fractional milliseconds
+ */
+double net_held_ms(uint64_t positive_ns, uint64_t negative_ns) {
+    return (static_cast<double>(positive_ns) - static_cast<double>(negative_ns)) / static_cast<double>(ns_per_ms);
+}
 
-    // xor
-    tick_result.set_function_params_modified(false);
-    if (left_key_timing.has_value() != right_key_timing.has_value()) {
-
-        if (left_key_timing.has_value()) {
-            tick_result.set_function_params_modified(true);
-            auto const panning_movement =
-                static_cast<GLfloat>(get<2>(*left_key_timing) - get<1>(*left_key_timing)) * panning_delta_per_ms;
-            logger->debug("panning {} in negative direction", panning_movement);
-            if (get<0>(*left_key_timing).has_shift()) {
-                function_params->y_offset -= panning_movement;
-            }
-            else {
-                function_params->x_offset -= panning_movement;
-            }
+/**
+ * @return the actions of the keys down right now
+ */
+std::bitset<ActionBindings::num_actions> held_actions(ActiveKeys const &active_keys,
+                                                      ActionBindings const &action_bindings) {
+    std::bitset<ActionBindings::num_actions> held;
+    for (auto const scan_code : action_bindings.get_scan_codes()) {
+        // holding the shifted key holds the unshifted one too
+        bool const shifted = active_keys.is_key_held(Key{scan_code, KeyMod::shift()});
+        if (!shifted && !active_keys.is_key_held(Key{scan_code, KeyMod::none()})) {
+            continue;
         }
 
-        if (right_key_timing.has_value()) {
-            tick_result.set_function_params_modified(true);
-            auto const panning_movement =
-                static_cast<GLfloat>(get<2>(*right_key_timing) - get<1>(*right_key_timing)) * panning_delta_per_ms;
-
-            logger->debug("panning {} in positive direction", panning_movement);
-            if (get<0>(*right_key_timing).has_shift()) {
-                function_params->y_offset += panning_movement;
-            }
-            else {
-                function_params->x_offset += panning_movement;
-            }
+        if (auto const action = action_bindings.lookup(scan_code, shifted); action.has_value()) {
+            held.set(static_cast<size_t>(*action));
         }
     }
 
-    if (up_key_timing.has_value() != down_key_timing.has_value()) {
+    return held;
+}
+} // namespace
+
+bool EventLoop::was_action_pressed_since(Action action, uint64_t start_ms) const {
+    return std::ranges::any_of(action_bindings.get_bindings(), [&](Binding const &binding) {
+        if (binding.action != action) {
+            return false;
+        }
 
-        if (up_key_timing.has_value()) {
-            tick_result.set_function_params_modified(true);
-            auto const z_mult_movement =
-                static_cast<GLfloat>(get<2>(*up_key_timing) - get<1>(*up_key_timing)) * z_mult_delta_per_ms;
-            logger->debug("changing z by {} in positive direction", z_mult_movement);
-            function_params->z_mult += z_mult_movement;
+        Key const shifted{binding.scan_code, KeyMod::shift()};
+        if (binding.shifted) {
+            return active_keys.was_key_pressed_since(shifted, start_ms);
         }
 
-        if (down_key_timing.has_value()) {
-            tick_result.set_function_params_modified(true);
-            auto const z_mult_movement =
-                static_cast<GLfloat>(get<2>(*down_key_timing) - get<1>(*down_key_timing)) * z_mult_delta_per_ms;
-            logger->debug("changing z by {} in negative direction", z_mult_movement);
-            function_params->z_mult -= z_mult_movement;
+        // pressing the shifted key presses the unshifted one too, which only counts if shift does the same
+        if (action_bindings.lookup(binding.scan_code, true) != action &&
+            active_keys.was_key_pressed_since(shifted, start_ms)) {
+            return false;
         }
+
+        return active_keys.was_key_pressed_since(Key{binding.scan_code, KeyMod::none()}, start_ms);
+    });
+}
+
+TickResult EventLoop::process_function_mutation_keys(TickResult tick_result) {
+    auto const held_ns = [this](Action action) { return held_actions_ns[static_cast<size_t>(action)]; };
+
+    auto const x_panning_ms = ::net_held_ms(held_ns(Action::pan_x_positive), held_ns(Action::pan_x_negative));
+    auto const y_panning_ms = ::net_held_ms(held_ns(Action::pan_y_positive), held_ns(Action::pan_y_negative));
+    auto const z_mult_ms = ::net_held_ms(held_ns(Action::z_mult_up), held_ns(Action::z_mult_down));
+
+    tick_result.set_function_params_modified(false);
+    if (x_panning_ms != 0.0 || y_panning_ms != 0.0) {
+        tick_result.set_function_params_modified(true);
+        auto const x_panning_movement = static_cast<GLfloat>(x_panning_ms) * panning_delta_per_ms;
+        auto const y_panning_movement = static_cast<GLfloat>(y_panning_ms) * panning_delta_per_ms;
+        logger->debug("panning by {}, {}", x_panning_movement, y_panning_movement);
+        function_params->x_offset += x_panning_movement;
+        function_params->y_offset += y_panning_movement;
+    }
+
+    if (z_mult_ms != 0.0) {
+        tick_result.set_function_params_modified(true);
+        auto const z_mult_movement = static_cast<GLfloat>(z_mult_ms) * z_mult_delta_per_ms;
+        logger->debug("changing z by {}", z_mult_movement);
+        function_params->z_mult += z_mult_movement;
     }
 
     return tick_result;
@@ -187,7 +221,7 @@ TickResult EventLoop::process_render_setting_keys(uint64_t start_ticks_ms, TickR
     }
 
     // TODO: should fix this so that holding down the toggling key doesn't cycle between the two infinitely
-    if (active_keys.was_key_pressed_since(SDL_SCANCODE_E, start_ticks_ms)) {
+    if (was_action_pressed_since(Action::toggle_wireframe, start_ticks_ms)) {
         tick_result.set_wireframe_display_mode_toggled(true);
         last_wireframe_only_change_at_msec = start_ticks_ms;
     }
@@ -195,6 +229,23 @@ TickResult EventLoop::process_render_setting_keys(uint64_t start_ticks_ms, TickR
     return tick_result;
 }
 
+TickResult EventLoop::process_plotted_function_keys(uint64_t start_ticks_ms, TickResult tick_result) {
+    tick_result.set_plotted_function_cycled(false);
+
+    if (last_plotted_function_change_at_msec.has_value() &&
+        *last_plotted_function_change_at_msec + msec_between_plotted_function_changes > start_ticks_ms) {
+        // not long enough since last change
+        return tick_result;
+    }
+
+    if (was_action_pressed_since(Action::next_function, start_ticks_ms)) {
+        tick_result.set_plotted_function_cycled(true);
+        last_plotted_function_change_at_msec = start_ticks_ms;
+    }
+
+    return tick_result;
+}
+
 TickResult EventLoop::process_tessellation_mutation_keys(uint64_t start_ticks_ms, TickResult tick_result) {
 
     tick_result.set_tessellation_settings_modified(false);
@@ -204,8 +255,8 @@ TickResult EventLoop::process_tessellation_mutation_keys(uint64_t start_ticks_ms
         return tick_result;
     }
 
-    bool const plus_key_timing = active_keys.was_key_pressed_since(SDLK_PLUS, start_ticks_ms);
-    bool const minus_key_timing = active_keys.was_key_pressed_since(SDLK_MINUS, start_ticks_ms);
+    bool const plus_key_timing = was_action_pressed_since(Action::tessellation_up, start_ticks_ms);
+    bool const minus_key_timing = was_action_pressed_since(Action::tessellation_down, start_ticks_ms);
 
     bool level_changed = false;
     if (plus_key_timing != minus_key_timing) {
@@ -230,51 +281,28 @@ TickResult EventLoop::process_tessellation_mutation_keys(uint64_t start_ticks_ms
     return tick_result;
 }
 
-TickResult EventLoop::process_model_mutation_keys(uint64_t start_ms, uint64_t end_ms, TickResult tick_result) {
-    using std::get;
-
-    auto const up_key_timing = active_keys.which_key_variant_was_pressed_since(start_ms, end_ms, SDL_SCANCODE_W);
-    auto const down_key_timing = active_keys.which_key_variant_was_pressed_since(start_ms, end_ms, SDL_SCANCODE_S);
-
-    auto const left_key_timing = active_keys.which_key_variant_was_pressed_since(start_ms, end_ms, SDL_SCANCODE_A);
-    auto const right_key_timing = active_keys.which_key_variant_was_pressed_since(start_ms, end_ms, SDL_SCANCODE_D);
-
-    auto const rotations_rads = static_cast<float>(rotation_rad_millis * static_cast<double>(end_ms - start_ms));
-    auto const slowed_rotations_rads =
-        static_cast<float>(slowed_rotation_rad_millis * static_cast<double>(end_ms - start_ms));
+TickResult EventLoop::process_model_mutation_keys(TickResult tick_result) {
+    auto const held_ns = [this](Action action) { return held_actions_ns[static_cast<size_t>(action)]; };
+
+    // each for exactly as long as it was held this tick
+    auto const x_rotation_rads = static_cast<float>(
+        rotation_rad_millis * ::net_held_ms(held_ns(Action::orbit_up), held_ns(Action::orbit_down)) +
+        slowed_rotation_rad_millis * ::net_held_ms(held_ns(Action::slow_orbit_up), held_ns(Action::slow_orbit_down)));
+    auto const y_rotation_rads = static_cast<float>(
+        rotation_rad_millis * ::net_held_ms(held_ns(Action::orbit_right), held_ns(Action::orbit_left)) +
+        slowed_rotation_rad_millis *
+            ::net_held_ms(held_ns(Action::slow_orbit_right), held_ns(Action::slow_orbit_left)));
     quat current(*model);
 
     tick_result.set_model_modified(false);
-    if (up_key_timing.has_value() != down_key_timing.has_value()) {
-        if (up_key_timing.has_value()) {
-            tick_result.set_model_modified(true);
-            quat const rotation =
-                angleAxis(get<0>(*up_key_timing).has_shift() ? slowed_rotations_rads : rotations_rads, x_axis);
-            current = rotation * current;
-        }
-
-        if (down_key_timing.has_value()) {
-            tick_result.set_model_modified(true);
-            quat const rotation =
-                angleAxis(-(get<0>(*down_key_timing).has_shift() ? slowed_rotations_rads : rotations_rads), x_axis);
-            current = rotation * current;
-        }
+    if (x_rotation_rads != 0.0f) {
+        tick_result.set_model_modified(true);
+        current = angleAxis(x_rotation_rads, x_axis) * current;
     }
 
-    if (left_key_timing.has_value() != right_key_timing.has_value()) {
-        if (left_key_timing.has_value()) {
-            tick_result.set_model_modified(true);
-            quat const rotation =
-                angleAxis(-(get<0>(*left_key_timing).has_shift() ? slowed_rotations_rads : rotations_rads), y_axis);
-            current = rotation * current;
-        }
-
-        if (right_key_timing.has_value()) {
-            tick_result.set_model_modified(true);
-            quat const rotation =
-                angleAxis(get<0>(*right_key_timing).has_shift() ? slowed_rotations_rads : rotations_rads, y_axis);
-            current = rotation * current;
-        }
+    if (y_rotation_rads != 0.0f) {
+        tick_result.set_model_modified(true);
+        current = angleAxis(y_rotation_rads, y_axis) * current;
     }
 
     if (tick_result.model_modified()) {
@@ -282,104 +310,204 @@ TickResult EventLoop::process_model_mutation_keys(uint64_t start_ms, uint64_t en
         *model = toMat4(current);
     }
 
+    auto const held = ::held_actions(active_keys, action_bindings);
+    auto const rads_per_ms = [&held](Action positive, Action negative, double rad_millis) {
+        return rad_millis * (static_cast<double>(held.test(static_cast<size_t>(positive))) -
+                             static_cast<double>(held.test(static_cast<size_t>(negative))));
+    };
+    auto const x_rads_per_ms = rads_per_ms(Action::orbit_up, Action::orbit_down, rotation_rad_millis) +
+                               rads_per_ms(Action::slow_orbit_up, Action::slow_orbit_down, slowed_rotation_rad_millis);
+    auto const y_rads_per_ms =
+        rads_per_ms(Action::orbit_right, Action::orbit_left, rotation_rad_millis) +
+        rads_per_ms(Action::slow_orbit_right, Action::slow_orbit_left, slowed_rotation_rad_millis);
+    model_rotation_rads_per_ns = glm::vec2(static_cast<float>(x_rads_per_ms / static_cast<double>(ns_per_ms)),
+                                           static_cast<float>(y_rads_per_ms / static_cast<double>(ns_per_ms)));
+
     return tick_result;
 }
 
-TickResult EventLoop::process_view_mutation_events(bool scrolled_toward_user, TickResult tick_result) {
+TickResult EventLoop::process_mouse_drag(TickResult tick_result) {
+    auto const delta = mouse_drag.take();
+    if (!delta.has_value()) {
+        return tick_result;
+    }
 
-    tick_result.set_view_modified(false);
-    if (scrolled_toward_user) {
-        // zoom out
-        *view = translate(*view, zoom_out);
-        tick_result.set_view_modified(true);
+    if (delta->button == SDL_BUTTON_LEFT) {
+        auto const rotation = arcball_rotation(delta->from, delta->to, window_size);
+        *model = toMat4(rotation * quat(*model));
+        tick_result.set_model_modified(true);
+        return tick_result;
     }
-    else {
-        // zoom in
-        *view = translate(*view, zoom_in);
+
+    // the surface follows the mouse, window y goes down
+    auto const moved = delta->to.to_vec() - delta->from.to_vec();
+    function_params->x_offset -= moved.x * panning_delta_per_px;
+    function_params->y_offset += moved.y * panning_delta_per_px;
+    tick_result.set_function_params_modified(true);
+    return tick_result;
+}
+
+TickResult EventLoop::process_view_mutation_events(Sint32 scroll_steps, TickResult tick_result) {
+
+    tick_result.set_view_modified(false);
+    if (scroll_steps != 0) {
+        // scrolling toward the user zooms out, a coalesced run of notches zooms by all of them at once
+        *view = translate(*view, zoom_in * static_cast<float>(scroll_steps));
         tick_result.set_view_modified(true);
     }
 
     return tick_result;
 }
 
-TickResult EventLoop::drain_event_queue(TickResult tick_result) {
+TickResult EventLoop::process_event(SDL_Event const &event, TickResult tick_result) {
+    // TODO: std::visit
+    if (event.type == SDL_EVENT_QUIT) {
+        tick_result.set_should_exit(true);
+    }
+    else if (event.type == SDL_EVENT_KEY_UP) {
+        const Key released{event.key.scancode, event.key.key, event.key.mod};
 
-    while (SDL_PollEvent(&evt)) {
-        // TODO: std::visit
-        if (evt.type == SDL_EVENT_QUIT) {
+        logger->debug("released key {0}", released);
+        active_keys.release_key(released, event.key.timestamp);
+        note_input(event.key.timestamp);
+    }
+    else if (event.type == SDL_EVENT_KEY_DOWN) {
+        const Key pressed{event.key.scancode, event.key.key, event.key.mod};
+
+        if (pressed.get_key_code()
+                .transform([](SDL_Keycode code) { return code == SDLK_Q || code == SDLK_ESCAPE; })
+                .value_or(false)) {
             tick_result.set_should_exit(true);
             return tick_result;
         }
-        else if (evt.type == SDL_EVENT_KEY_UP) {
-            const Key released{evt.key.scancode, evt.key.key, evt.key.mod};
-
-            logger->debug("released key {0}", released);
-            active_keys.release_key(released);
-        }
-        else if (evt.type == SDL_EVENT_KEY_DOWN) {
-            const Key pressed{evt.key.scancode, evt.key.key, evt.key.mod};
-
-            if (pressed.get_key_code()
-                    .transform([](SDL_Keycode code) { return code == SDLK_Q || code == SDLK_ESCAPE; })
-                    .value_or(false)) {
-                tick_result.set_should_exit(true);
-                return tick_result;
-            }
 
-            logger->debug("pressed key {0}", pressed);
+        logger->debug("pressed key {0}", pressed);
 
-            // mouse clicks disable keys
-            if (start_click.has_value()) {
-                continue;
-            }
+        // mouse clicks disable keys
+        if (mouse_drag.is_dragging()) {
+            return tick_result;
+        }
 
-            active_keys.press_key(pressed);
+        active_keys.press_key(pressed, event.key.timestamp);
+        if (!event.key.repeat) {
+            note_input(event.key.timestamp);
         }
-        else if (evt.type == SDL_EVENT_MOUSE_BUTTON_DOWN) {
-            // TODO: implement this
-            start_click = nullopt;
-            // start_click = make_optional<MouseLoc>(evt.motion.x, evt.motion.y);
+    }
+    else if (event.type == SDL_EVENT_MOUSE_BUTTON_DOWN) {
+        if (event.button.button == SDL_BUTTON_LEFT || event.button.button == SDL_BUTTON_RIGHT) {
+            mouse_drag.press(event.button.button, MouseLoc{event.button.x, event.button.y});
         }
-        else if (evt.type == SDL_EVENT_MOUSE_BUTTON_UP) {
-            start_click = nullopt;
+    }
+    else if (event.type == SDL_EVENT_MOUSE_BUTTON_UP) {
+        mouse_drag.release(event.button.button, MouseLoc{event.button.x, event.button.y});
+    }
+    else if (event.type == SDL_EVENT_WINDOW_EXPOSED || event.type == SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED) {
+        // the last frame is not retained by the window system
+        tick_result.set_redraw_requested(true);
+    }
+    else if (event.type == SDL_EVENT_MOUSE_WHEEL) {
+        // the view may already have been zoomed by an earlier wheel event this tick
+        bool const view_modified = tick_result.view_modified();
+        tick_result = process_view_mutation_events(event.wheel.integer_y, tick_result);
+        tick_result.set_view_modified(view_modified || tick_result.view_modified());
+        note_input(event.wheel.timestamp);
+    }
+    else if (event.type == SDL_EVENT_MOUSE_MOTION) {
+        // only where it ended up matters, the drag is applied once a tick
+        mouse_drag.move(MouseLoc{event.motion.x, event.motion.y});
+    }
+
+    return tick_result;
+}
+
+void EventLoop::note_input(uint64_t timestamp_ns) noexcept {
+    // events are processed in queue order, the first one is the oldest
+    if (oldest_input_ns == 0) {
+        oldest_input_ns = timestamp_ns;
+    }
+}
+
+TickResult EventLoop::drain_event_queue(TickResult tick_result) {
+    SDL_PumpEvents();
+
+    // taking events off in batches lets runs of wheel / motion / key repeat events be merged before processing
+    int num_events = 0;
+    while ((num_events = SDL_PeepEvents(events.data(), static_cast<int>(events.size()), SDL_GETEVENT,
+                                        SDL_EVENT_FIRST, SDL_EVENT_LAST)) > 0) {
+        if (recording.has_value()) {
+            recording->add_batch(span{events.data(), static_cast<size_t>(num_events)});
         }
-        else if (evt.type == SDL_EVENT_MOUSE_WHEEL) {
-            tick_result = process_view_mutation_events(evt.wheel.integer_y < 0, tick_result);
+
+        tick_result = process_batch(static_cast<size_t>(num_events), tick_result);
+        if (tick_result.should_exit()) {
+            return tick_result;
         }
-        else if (start_click.has_value() && evt.type == SDL_EVENT_MOUSE_MOTION) {
-            // TODO: implement this
-            // MouseLoc current(evt.motion.x, evt.motion.y);
+    }
+
+    return tick_result;
+}
+
+TickResult EventLoop::process_batch(size_t num_events, TickResult tick_result) {
+    auto const kept = coalesce_events(span{events.data(), num_events});
+    for (auto const &event : span{events.data(), kept}) {
+        tick_result = process_event(event, tick_result);
+        if (tick_result.should_exit()) {
+            return tick_result;
         }
     }
 
     return tick_result;
 }
 
-TickResult EventLoop::process_frame(uint64_t render_time_ns) {
-    auto const start_ticks_ms = SDL_GetTicks();
-    auto const start_ticks_ns = SDL_GetTicksNS();
+TickResult EventLoop::process_frame(uint64_t deadline_ns, uint64_t render_time_ns) {
+    if (replay.has_value()) {
+        return replay_frame();
+    }
+
+    auto const start_ns = SDL_GetTicksNS();
+    auto const start_ticks_ms = start_ns / ns_per_ms;
+    if (recording.has_value()) {
+        recording->begin_tick(start_ns);
+    }
 
     /** what ticks ns timestamp to not exceed to maintain fps */
-    auto const absolute_max_end_ticks_ns = start_ticks_ns + max_sleep_ns_per_tick - render_time_ns;
+    auto const absolute_max_end_ticks_ns = deadline_ns > render_time_ns ? deadline_ns - render_time_ns : 0;
 
     // what's the latest ticks ns that can do another sdl event queue drain
     // without likely going over the time allowed to process the frame
-    auto end_ticks_ns = absolute_max_end_ticks_ns - event_poll_timings.get_avg();
+    auto end_ticks_ns = absolute_max_end_ticks_ns - std::min(absolute_max_end_ticks_ns, event_poll_timings.get_avg());
 
     auto drain_start_ns = SDL_GetTicksNS();
     if (drain_start_ns >= end_ticks_ns) {
-        logger->warn("skipping input polling this tick");
+        logger->warn("skipping input processing this tick");
         // not entirely accurate, is used to prevent a couple of slow input poll loops
         // from locking out all input polling by dropping down the average
         event_poll_timings.add(0);
-        SDL_FlushEvents(SDL_EVENT_QUIT + 1, SDL_EVENT_ENUM_PADDING);
-        return TickResult{SDL_GetTicks() - start_ticks_ms, false, true};
+
+        // coalesced the queue is cheap to drain, and throwing it away would lose key ups and leave keys stuck
+        auto tick_result = drain_event_queue(TickResult{0, false, true});
+        tick_result.elapsed_ticks_ms = SDL_GetTicks() - start_ticks_ms;
+        if (recording.has_value()) {
+            recording->end_tick(nullopt);
+        }
+        return tick_result;
     }
 
     TickResult tick_result{SDL_GetTicks() - start_ticks_ms, false, false};
     while ((drain_start_ns = SDL_GetTicksNS()) < end_ticks_ns) {
+        // sleep until the next event or the deadline rather than spinning on SDL_PollEvent,
+        // passing no event leaves it in the queue for drain_event_queue
+        auto const remaining_ms = static_cast<Sint32>((end_ticks_ns - drain_start_ns) / ns_per_ms);
+        if (remaining_ms > 0 && !SDL_WaitEventTimeout(nullptr, remaining_ms)) {
+            continue;
+        }
+
+        drain_start_ns = SDL_GetTicksNS();
         tick_result = drain_event_queue(tick_result);
         if (tick_result.should_exit()) {
+            if (recording.has_value()) {
+                recording->end_tick(nullopt);
+            }
             return tick_result;
         }
 
@@ -387,17 +515,102 @@ TickResult EventLoop::process_frame(uint64_t render_time_ns) {
 
         // adjust timing expectations based on latest data
         event_poll_timings.add(drain_end_ns - drain_start_ns);
-        end_ticks_ns = absolute_max_end_ticks_ns - event_poll_timings.get_avg();
+        end_ticks_ns = absolute_max_end_ticks_ns - std::min(absolute_max_end_ticks_ns, event_poll_timings.get_avg());
+
+        if (remaining_ms == 0) {
+            // under a millisecond left, too short to wait on so drain once rather than spin
+            break;
+        }
     }
 
     // TODO: track this overhead separately and use to compute how much input to process
     // per frame
 
-    tick_result = process_function_mutation_keys(start_ticks_ms, tick_result);
-    tick_result = process_model_mutation_keys(start_ticks_ms, SDL_GetTicks(), tick_result);
+    auto const integrate_until_ns = SDL_GetTicksNS();
+    if (recording.has_value()) {
+        recording->end_tick(integrate_until_ns);
+    }
+
+    tick_result = process_held_keys(start_ticks_ms, integrate_until_ns, tick_result);
+    tick_result.elapsed_ticks_ms = SDL_GetTicks() - start_ticks_ms;
+    return tick_result;
+}
+
+TickResult EventLoop::process_held_keys(uint64_t start_ticks_ms, uint64_t integrate_until_ns,
+                                        TickResult tick_result) {
+    // key events are stamped with when they happened, not when they were drained, so the held time only
+    // depends on how the user pressed the keys. a press still sitting in the queue counts from the next window
+    active_keys.held_durations(integrated_until_ns, integrate_until_ns, action_bindings.get_scan_codes(), held_keys);
+    held_actions_ns = action_bindings.held_ns(held_keys);
+    integrated_until_ns = integrate_until_ns;
+
+    tick_result = process_function_mutation_keys(tick_result);
+    tick_result = process_model_mutation_keys(tick_result);
+    tick_result = process_mouse_drag(tick_result);
     tick_result = process_tessellation_mutation_keys(start_ticks_ms, tick_result);
     tick_result = process_render_setting_keys(start_ticks_ms, tick_result);
+    tick_result = process_plotted_function_keys(start_ticks_ms, tick_result);
+    return tick_result;
+}
 
-    tick_result.elapsed_ticks_ms = SDL_GetTicks() - start_ticks_ms;
+TickResult EventLoop::replay_frame() {
+    // live input is ignored so runs compare, other than closing the window
+    SDL_PumpEvents();
+    bool const quit = SDL_HasEvent(SDL_EVENT_QUIT);
+    SDL_FlushEvents(SDL_EVENT_FIRST, SDL_EVENT_LAST);
+    if (quit || replay->is_finished()) {
+        return TickResult{0, true, false};
+    }
+
+    // at the recorded pace, so frame times compare too
+    if (auto const due_ns = replay->get_next_due_ns(), now_ns = SDL_GetTicksNS(); due_ns > now_ns) {
+        SDL_DelayNS(due_ns - now_ns);
+    }
+
+    auto const tick = replay->next();
+    auto const start_ticks_ms = tick.start_ns / ns_per_ms;
+
+    // the same path as drain_event_queue and the skipped tick took, on the recorded clock
+    TickResult tick_result{0, false, !tick.integrated_until_ns.has_value()};
+    for (auto const &batch : tick.batches) {
+        auto const num_events = std::min(batch.size(), events.size());
+        std::copy_n(batch.begin(), num_events, events.begin());
+        tick_result = process_batch(num_events, tick_result);
+        if (tick_result.should_exit()) {
+            return tick_result;
+        }
+    }
+
+    if (!tick.integrated_until_ns.has_value()) {
+        return tick_result;
+    }
+
+    tick_result = process_held_keys(start_ticks_ms, *tick.integrated_until_ns, tick_result);
+    tick_result.elapsed_ticks_ms = *tick.integrated_until_ns / ns_per_ms - start_ticks_ms;
     return tick_result;
 }
+
+uint64_t EventLoop::get_integrated_until_ns() const noexcept {
+    return integrated_until_ns;
+}
+
+glm::vec2 EventLoop::get_model_rotation_rads_per_ns() const noexcept {
+    return model_rotation_rads_per_ns;
+}
+
+uint64_t EventLoop::take_input_timestamp_ns() noexcept {
+    return std::exchange(oldest_input_ns, 0);
+}
+
+void EventLoop::start_recording() {
+    recording.emplace(integrated_until_ns);
+}
+
+optional<InputRecording> const &EventLoop::get_recording() const noexcept {
+    return recording;
+}
+
+void EventLoop::start_replay(InputRecording const &recorded) {
+    replay.emplace(recorded, SDL_GetTicksNS());
+    integrated_until_ns = replay->get_started_at_ns();
+}
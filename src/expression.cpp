@@ -0,0 +1,653 @@
+#include "expression.hpp"
+#include "exceptions.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <functional>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using std::format;
+using std::size_t;
+using std::span;
+using std::string;
+using std::string_view;
+using std::vector;
+
+namespace {
+
+struct FunctionInfo {
+    string_view name;
+    ExpressionOp op;
+    size_t arity;
+};
+
+constexpr std::array functions{
+    FunctionInfo{"sin", ExpressionOp::sin, 1},   FunctionInfo{"cos", ExpressionOp::cos, 1},
+    FunctionInfo{"tan", ExpressionOp::tan, 1},   FunctionInfo{"sqrt", ExpressionOp::sqrt, 1},
+    FunctionInfo{"abs", ExpressionOp::abs, 1},   FunctionInfo{"exp", ExpressionOp::exp, 1},
+    FunctionInfo{"log", ExpressionOp::log, 1},   FunctionInfo{"pow", ExpressionOp::power, 2},
+};
+
+ExpressionNode make_constant(double value) {
+    return ExpressionNode{ExpressionOp::constant, value, {}};
+}
+
+ExpressionNode make_node(ExpressionOp op, vector<ExpressionNode> &&children) {
+    return ExpressionNode{op, 0.0, std::move(children)};
+}
+
+bool is_constant_value(ExpressionNode const &node, double value) {
+    return node.is_constant() && node.value == value;
+}
+
+/**
+ * recursive descent parser
+ * expr    := term (('+' | '-') term)*
+ * term    := unary (('*' | '/') unary)*
+ * unary   := '-' unary | power
+ * power   := primary ('^' unary)?
+ * primary := number | identifier | identifier '(' expr (',' expr)* ')' | '(' expr ')'
+ */
+class Parser {
+    string_view source;
+    size_t pos;
+
+    [[noreturn]] void fail(string_view msg) const {
+        throw ExpressionError(format("{0} at position {1} in \"{2}\"", msg, pos, source));
+    }
+
+    void skip_whitespace() {
+        while (pos < source.size() && std::isspace(static_cast<unsigned char>(source[pos])) != 0) {
+            ++pos;
+        }
+    }
+
+    bool consume(char c) {
+        skip_whitespace();
+        if (pos < source.size() && source[pos] == c) {
+            ++pos;
+            return true;
+        }
+
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) {
+            fail(format("expected '{}'", c));
+        }
+    }
+
+    ExpressionNode parse_number() {
+        auto const start = pos;
+        while (pos < source.size() &&
+               (std::isdigit(static_cast<unsigned char>(source[pos])) != 0 || source[pos] == '.')) {
+            ++pos;
+        }
+
+        // exponent
+        if (pos < source.size() && (source[pos] == 'e' || source[pos] == 'E')) {
+            auto exponent_pos = pos + 1;
+            if (exponent_pos < source.size() && (source[exponent_pos] == '+' || source[exponent_pos] == '-')) {
+                ++exponent_pos;
+            }
+
+            if (exponent_pos < source.size() && std::isdigit(static_cast<unsigned char>(source[exponent_pos])) != 0) {
+                pos = exponent_pos;
+                while (pos < source.size() && std::isdigit(static_cast<unsigned char>(source[pos])) != 0) {
+                    ++pos;
+                }
+            }
+        }
+
+        auto const text = string{source.substr(start, pos - start)};
+        size_t parsed = 0;
+        double value = 0.0;
+        try {
+            value = std::stod(text, &parsed);
+        }
+        catch (std::exception const &) {
+            fail(format("invalid number {}", text));
+        }
+
+        if (parsed != text.size()) {
+            fail(format("invalid number {}", text));
+        }
+
+        return make_constant(value);
+    }
+
+    ExpressionNode parse_identifier() {
+        auto const start = pos;
+        while (pos < source.size() &&
+               (std::isalnum(static_cast<unsigned char>(source[pos])) != 0 || source[pos] == '_')) {
+            ++pos;
+        }
+
+        auto const name = source.substr(start, pos - start);
+        if (name == "x") {
+            return make_node(ExpressionOp::x, {});
+        }
+        else if (name == "y") {
+            return make_node(ExpressionOp::y, {});
+        }
+        else if (name == "pi") {
+            return make_constant(std::numbers::pi);
+        }
+        else if (name == "e") {
+            return make_constant(std::numbers::e);
+        }
+
+        auto const function = std::ranges::find(functions, name, &FunctionInfo::name);
+        if (function == functions.end()) {
+            pos = start;
+            fail(format("unknown identifier {}", name));
+        }
+
+        expect('(');
+        vector<ExpressionNode> args;
+        args.push_back(parse_expr());
+        while (consume(',')) {
+            args.push_back(parse_expr());
+        }
+        expect(')');
+
+        if (args.size() != function->arity) {
+            fail(format("{0} takes {1} arguments but got {2}", name, function->arity, args.size()));
+        }
+
+        return make_node(function->op, std::move(args));
+    }
+
+    ExpressionNode parse_primary() {
+        skip_whitespace();
+        if (pos >= source.size()) {
+            fail("unexpected end of expression");
+        }
+
+        auto const c = static_cast<unsigned char>(source[pos]);
+        if (std::isdigit(c) != 0 || c == '.') {
+            return parse_number();
+        }
+        else if (std::isalpha(c) != 0) {
+            return parse_identifier();
+        }
+        else if (consume('(')) {
+            auto inner = parse_expr();
+            expect(')');
+            return inner;
+        }
+
+        fail(format("unexpected '{}'", source[pos]));
+    }
+
+    ExpressionNode parse_power() {
+        auto base = parse_primary();
+        if (consume('^')) {
+            // right associative, and binds tighter than unary minus on the left: -x^2 == -(x^2)
+            auto exponent = parse_unary();
+            vector<ExpressionNode> children;
+            children.push_back(std::move(base));
+            children.push_back(std::move(exponent));
+            return make_node(ExpressionOp::power, std::move(children));
+        }
+
+        return base;
+    }
+
+    ExpressionNode parse_unary() {
+        if (consume('-')) {
+            vector<ExpressionNode> children;
+            children.push_back(parse_unary());
+            return make_node(ExpressionOp::negate, std::move(children));
+        }
+        else if (consume('+')) {
+            return parse_unary();
+        }
+
+        return parse_power();
+    }
+
+    ExpressionNode parse_binary_chain(ExpressionNode (Parser::*parse_operand)(), char lhs_op_char,
+                                      ExpressionOp lhs_op, char rhs_op_char, ExpressionOp rhs_op) {
+        auto lhs = (this->*parse_operand)();
+        while (true) {
+            ExpressionOp op = lhs_op;
+            if (consume(lhs_op_char)) {
+                op = lhs_op;
+            }
+            else if (consume(rhs_op_char)) {
+                op = rhs_op;
+            }
+            else {
+                return lhs;
+            }
+
+            vector<ExpressionNode> children;
+            children.push_back(std::move(lhs));
+            children.push_back((this->*parse_operand)());
+            lhs = make_node(op, std::move(children));
+        }
+    }
+
+    ExpressionNode parse_term() {
+        return parse_binary_chain(&Parser::parse_unary, '*', ExpressionOp::multiply, '/', ExpressionOp::divide);
+    }
+
+    ExpressionNode parse_expr() {
+        return parse_binary_chain(&Parser::parse_term, '+', ExpressionOp::add, '-', ExpressionOp::subtract);
+    }
+
+public:
+    explicit Parser(string_view source) : source(source), pos(0) {
+    }
+
+    ExpressionNode parse() {
+        auto result = parse_expr();
+        skip_whitespace();
+        if (pos != source.size()) {
+            fail(format("unexpected '{}'", source[pos]));
+        }
+
+        return result;
+    }
+};
+
+template <typename T> T apply_unary(ExpressionOp op, T a) {
+    switch (op) {
+    case ExpressionOp::negate:
+        return -a;
+    case ExpressionOp::square:
+        return a * a;
+    case ExpressionOp::sin:
+        return std::sin(a);
+    case ExpressionOp::cos:
+        return std::cos(a);
+    case ExpressionOp::tan:
+        return std::tan(a);
+    case ExpressionOp::sqrt:
+        return std::sqrt(a);
+    case ExpressionOp::abs:
+        return std::abs(a);
+    case ExpressionOp::exp:
+        return std::exp(a);
+    case ExpressionOp::log:
+        return std::log(a);
+    default:
+        assert(false && "not a unary op");
+        return a;
+    }
+}
+
+template <typename T> T apply_binary(ExpressionOp op, T a, T b) {
+    switch (op) {
+    case ExpressionOp::add:
+        return a + b;
+    case ExpressionOp::subtract:
+        return a - b;
+    case ExpressionOp::multiply:
+        return a * b;
+    case ExpressionOp::divide:
+        return a / b;
+    case ExpressionOp::power:
+        return std::pow(a, b);
+    default:
+        assert(false && "not a binary op");
+        return a;
+    }
+}
+
+/**
+ * op on every lane of the operand in place, branch free so the loop vectorizes
+ */
+template <typename Op> void unary_lanes(span<float> operand, Op op) {
+    for (auto &lane : operand) {
+        lane = op(lane);
+    }
+}
+
+/**
+ * op on every lane of lhs and rhs, written back to lhs
+ */
+template <typename Op> void binary_lanes(span<float> lhs, span<const float> rhs, Op op) {
+    for (size_t lane = 0; lane < lhs.size(); ++lane) {
+        lhs[lane] = op(lhs[lane], rhs[lane]);
+    }
+}
+
+string_view op_name(ExpressionOp op) {
+    switch (op) {
+    case ExpressionOp::sin:
+        return "sin";
+    case ExpressionOp::cos:
+        return "cos";
+    case ExpressionOp::tan:
+        return "tan";
+    case ExpressionOp::sqrt:
+        return "sqrt";
+    case ExpressionOp::abs:
+        return "abs";
+    case ExpressionOp::exp:
+        return "exp";
+    case ExpressionOp::log:
+        return "log";
+    case ExpressionOp::power:
+        return "pow";
+    case ExpressionOp::add:
+        return "+";
+    case ExpressionOp::subtract:
+        return "-";
+    case ExpressionOp::multiply:
+        return "*";
+    case ExpressionOp::divide:
+        return "/";
+    default:
+        return "?";
+    }
+}
+
+bool is_infix(ExpressionOp op) {
+    return op == ExpressionOp::add || op == ExpressionOp::subtract || op == ExpressionOp::multiply ||
+           op == ExpressionOp::divide;
+}
+
+/**
+ * glsl float literal, which always needs a decimal point or exponent
+ * throws ExpressionError if the value does not fit in a float, it would print as inf which glsl does not have
+ */
+string glsl_float(double value) {
+    if (std::abs(value) > std::numeric_limits<float>::max()) {
+        throw ExpressionError(format("{} is out of range of a float", value));
+    }
+
+    auto literal = format("{}", static_cast<float>(value));
+    if (literal.find_first_of(".e") == string::npos) {
+        literal += ".0";
+    }
+
+    return value < 0.0 ? format("({})", literal) : literal;
+}
+} // namespace
+
+ExpressionNode parse_expression(string_view source) {
+    return Parser{source}.parse();
+}
+
+ExpressionNode optimize_expression(ExpressionNode node) {
+    for (auto &child : node.children) {
+        child = optimize_expression(std::move(child));
+    }
+
+    if (node.is_leaf()) {
+        return node;
+    }
+
+    // constant folding
+    if (std::ranges::all_of(node.children, &ExpressionNode::is_constant)) {
+        auto const folded = node.children.size() == 1
+                                ? ::apply_unary(node.op, node.children[0].value)
+                                : ::apply_binary(node.op, node.children[0].value, node.children[1].value);
+        if (!std::isfinite(folded)) {
+            throw ExpressionError(format("{} does not evaluate to a finite number", expression_to_string(node)));
+        }
+
+        return ::make_constant(folded);
+    }
+
+    auto &children = node.children;
+    switch (node.op) {
+    case ExpressionOp::power:
+        // strength reduction, also sidesteps glsl pow being undefined for negative bases
+        if (::is_constant_value(children[1], 2.0)) {
+            vector<ExpressionNode> base;
+            base.push_back(std::move(children[0]));
+            return ::make_node(ExpressionOp::square, std::move(base));
+        }
+        else if (::is_constant_value(children[1], 1.0)) {
+            return std::move(children[0]);
+        }
+        else if (::is_constant_value(children[1], 0.0)) {
+            return ::make_constant(1.0);
+        }
+        else if (::is_constant_value(children[1], 0.5)) {
+            vector<ExpressionNode> base;
+            base.push_back(std::move(children[0]));
+            return ::make_node(ExpressionOp::sqrt, std::move(base));
+        }
+        break;
+    case ExpressionOp::multiply:
+        if (::is_constant_value(children[0], 1.0)) {
+            return std::move(children[1]);
+        }
+        else if (::is_constant_value(children[1], 1.0)) {
+            return std::move(children[0]);
+        }
+        break;
+    case ExpressionOp::add:
+        if (::is_constant_value(children[0], 0.0)) {
+            return std::move(children[1]);
+        }
+        else if (::is_constant_value(children[1], 0.0)) {
+            return std::move(children[0]);
+        }
+        break;
+    case ExpressionOp::subtract:
+    case ExpressionOp::divide:
+        if (::is_constant_value(children[1], node.op == ExpressionOp::subtract ? 0.0 : 1.0)) {
+            return std::move(children[0]);
+        }
+        break;
+    case ExpressionOp::negate:
+        if (children[0].op == ExpressionOp::negate) {
+            return std::move(children[0].children[0]);
+        }
+        break;
+    default:
+        break;
+    }
+
+    return node;
+}
+
+string expression_to_string(ExpressionNode const &node) {
+    switch (node.op) {
+    case ExpressionOp::constant:
+        return format("{}", node.value);
+    case ExpressionOp::x:
+        return "x";
+    case ExpressionOp::y:
+        return "y";
+    case ExpressionOp::negate:
+        return format("(-{})", expression_to_string(node.children[0]));
+    case ExpressionOp::square:
+        return format("pow({}, 2)", expression_to_string(node.children[0]));
+    default:
+        break;
+    }
+
+    if (::is_infix(node.op)) {
+        return format("({0} {1} {2})", expression_to_string(node.children[0]), ::op_name(node.op),
+                      expression_to_string(node.children[1]));
+    }
+    else if (node.op == ExpressionOp::power) {
+        return format("pow({0}, {1})", expression_to_string(node.children[0]),
+                      expression_to_string(node.children[1]));
+    }
+
+    return format("{0}({1})", ::op_name(node.op), expression_to_string(node.children[0]));
+}
+
+string expression_to_glsl(ExpressionNode const &node) {
+    switch (node.op) {
+    case ExpressionOp::constant:
+        return ::glsl_float(node.value);
+    case ExpressionOp::x:
+        return "x";
+    case ExpressionOp::y:
+        return "y";
+    case ExpressionOp::negate:
+        return format("(-{})", expression_to_glsl(node.children[0]));
+    case ExpressionOp::square: {
+        auto const base = expression_to_glsl(node.children[0]);
+        // only duplicate trivial bases, otherwise use the helper so the base is evaluated once
+        return node.children[0].is_leaf() ? format("({0} * {0})", base) : format("expression_square({})", base);
+    }
+    default:
+        break;
+    }
+
+    if (::is_infix(node.op)) {
+        return format("({0} {1} {2})", expression_to_glsl(node.children[0]), ::op_name(node.op),
+                      expression_to_glsl(node.children[1]));
+    }
+    else if (node.op == ExpressionOp::power) {
+        return format("pow({0}, {1})", expression_to_glsl(node.children[0]), expression_to_glsl(node.children[1]));
+    }
+
+    return format("{0}({1})", ::op_name(node.op), expression_to_glsl(node.children[0]));
+}
+
+CpuExpression::CpuExpression(ExpressionNode const &node) : max_stack_depth(0) {
+    emit(node, 1);
+}
+
+void CpuExpression::emit(ExpressionNode const &node, size_t depth) {
+    // post order so operands are on the stack before their operator
+    for (size_t i = 0; i < node.children.size(); ++i) {
+        emit(node.children[i], depth + i);
+    }
+
+    max_stack_depth = std::max(max_stack_depth, depth);
+    program.push_back(Instruction{node.op, static_cast<float>(node.value)});
+}
+
+float CpuExpression::evaluate(float x, float y) const {
+    float result = 0.0f;
+    evaluate(span<const float>{&x, 1}, span<const float>{&y, 1}, span<float>{&result, 1});
+    return result;
+}
+
+void CpuExpression::evaluate(span<const float> xs, span<const float> ys, span<float> out) const {
+    assert(xs.size() == ys.size() && xs.size() == out.size());
+
+    // one block of lanes per stack slot
+    vector<float> stack(max_stack_depth * block_size);
+
+    for (size_t block_start = 0; block_start < xs.size(); block_start += block_size) {
+        auto const lanes = std::min(block_size, xs.size() - block_start);
+        auto const slot = [&](size_t index) { return span{stack}.subspan(index * block_size, lanes); };
+        size_t top = 0;
+
+        for (auto const &instruction : program) {
+            // dispatch once per instruction, each case is one loop over the block
+            switch (instruction.op) {
+            case ExpressionOp::constant:
+                std::ranges::fill(slot(top++), instruction.value);
+                break;
+            case ExpressionOp::x:
+                std::ranges::copy(xs.subspan(block_start, lanes), slot(top++).begin());
+                break;
+            case ExpressionOp::y:
+                std::ranges::copy(ys.subspan(block_start, lanes), slot(top++).begin());
+                break;
+            case ExpressionOp::add:
+                ::binary_lanes(slot(top - 2), slot(top - 1), [](float a, float b) { return a + b; });
+                --top;
+                break;
+            case ExpressionOp::subtract:
+                ::binary_lanes(slot(top - 2), slot(top - 1), [](float a, float b) { return a - b; });
+                --top;
+                break;
+            case ExpressionOp::multiply:
+                ::binary_lanes(slot(top - 2), slot(top - 1), [](float a, float b) { return a * b; });
+                --top;
+                break;
+            case ExpressionOp::divide:
+                ::binary_lanes(slot(top - 2), slot(top - 1), [](float a, float b) { return a / b; });
+                --top;
+                break;
+            case ExpressionOp::power:
+                ::binary_lanes(slot(top - 2), slot(top - 1), [](float a, float b) { return std::pow(a, b); });
+                --top;
+                break;
+            case ExpressionOp::square:
+                ::unary_lanes(slot(top - 1), [](float a) { return a * a; });
+                break;
+            case ExpressionOp::negate:
+                ::unary_lanes(slot(top - 1), [](float a) { return -a; });
+                break;
+            case ExpressionOp::sin:
+                ::unary_lanes(slot(top - 1), [](float a) { return std::sin(a); });
+                break;
+            case ExpressionOp::cos:
+                ::unary_lanes(slot(top - 1), [](float a) { return std::cos(a); });
+                break;
+            case ExpressionOp::tan:
+                ::unary_lanes(slot(top - 1), [](float a) { return std::tan(a); });
+                break;
+            case ExpressionOp::sqrt:
+                ::unary_lanes(slot(top - 1), [](float a) { return std::sqrt(a); });
+                break;
+            case ExpressionOp::abs:
+                ::unary_lanes(slot(top - 1), [](float a) { return std::abs(a); });
+                break;
+            case ExpressionOp::exp:
+                ::unary_lanes(slot(top - 1), [](float a) { return std::exp(a); });
+                break;
+            case ExpressionOp::log:
+                ::unary_lanes(slot(top - 1), [](float a) { return std::log(a); });
+                break;
+            }
+        }
+
+        assert(top == 1);
+        std::ranges::copy(slot(0), out.subspan(block_start, lanes).begin());
+    }
+}
+
+size_t CpuExpression::instruction_count() const noexcept {
+    return program.size();
+}
+
+CompiledExpression::CompiledExpression(string_view source)
+    : source(source), ast(optimize_expression(parse_expression(source))), canonical(expression_to_string(ast)),
+      glsl(format("float expression_square(float v) {{\n    return v * v;\n}}\n\n"
+                  "float {0}(float x, float y) {{\n    return {1};\n}}\n",
+                  glsl_function_name, expression_to_glsl(ast))),
+      cpu(ast), hash(std::hash<string>{}(canonical)) {
+}
+
+string const &CompiledExpression::get_source() const noexcept {
+    return source;
+}
+
+ExpressionNode const &CompiledExpression::get_ast() const noexcept {
+    return ast;
+}
+
+string const &CompiledExpression::get_canonical() const noexcept {
+    return canonical;
+}
+
+string const &CompiledExpression::get_glsl() const noexcept {
+    return glsl;
+}
+
+CpuExpression const &CompiledExpression::get_cpu() const noexcept {
+    return cpu;
+}
+
+size_t CompiledExpression::get_hash() const noexcept {
+    return hash;
+}
@@ -0,0 +1,77 @@
+#include "frame_fences.hpp"
+#include "exceptions.hpp"
+#include "gl_inspect.hpp"
+#include "logging.hpp"
+
+#include "glad/glad.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+
+#include <SDL3/SDL.h>
+#include <spdlog/spdlog.h>
+
+using std::size_t;
+
+/** how long a single glClientWaitSync may block before checking again */
+static constexpr const GLuint64 fence_wait_timeout_ns = 1'000'000'000;
+
+FrameFences::FrameFences(size_t frames_in_flight)
+    : fences(std::clamp<size_t>(frames_in_flight, 1, max_frames_in_flight), nullptr), next(0),
+      logger(get_or_create_stdout_logger("frame_fences")) {
+    logger->info("{} frame(s) in flight", fences.size());
+}
+
+FrameFences::~FrameFences() {
+    for (auto const fence : fences) {
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+        }
+    }
+}
+
+uint64_t FrameFences::wait_for_slot() {
+    auto &fence = fences[next];
+    if (fence == nullptr) {
+        return 0;
+    }
+
+    auto const start_ns = SDL_GetTicksNS();
+    while (true) {
+        auto const result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, fence_wait_timeout_ns);
+        if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+            break;
+        }
+
+        if (result == GL_WAIT_FAILED) {
+            throw WrappedOpenGLError(
+                std::format("waiting on frame fence failed: {}", gl_get_error_string(glGetError())));
+        }
+
+        logger->warn("still waiting on the gpu to finish a frame");
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+
+    auto const waited_ns = SDL_GetTicksNS() - start_ns;
+    logger->trace("waited {} ns on the gpu", waited_ns);
+    return waited_ns;
+}
+
+void FrameFences::frame_submitted() {
+    auto &fence = fences[next];
+    if (fence != nullptr) {
+        // wait_for_slot was skipped, don't leak the old one
+        glDeleteSync(fence);
+    }
+
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    next = (next + 1) % fences.size();
+}
+
+size_t FrameFences::get_frames_in_flight() const noexcept {
+    return fences.size();
+}
@@ -0,0 +1,110 @@
+#include "frame_pacer.hpp"
+#include "consts.hpp"
+#include "frame_time_stats.hpp"
+#include "logging.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+#include <SDL3/SDL.h>
+#include <spdlog/spdlog.h>
+
+/** leave this much of the wait to spinning, covers the usual sleep overshoot */
+static constexpr const uint64_t spin_threshold_ns = 2'000'000;
+
+/**
+ * after a vsynced swap the next frame is scheduled this much before the next vblank so that the
+ * swap waits on the display instead of just missing it
+ */
+static constexpr const uint64_t vsync_margin_ns = 1'000'000;
+
+namespace {
+
+/**
+ * @return refresh rate in hz of the display the window is on, target_fps if unknown
+ */
+float display_refresh_rate(SDL_Window *window, std::shared_ptr<spdlog::logger> const &logger) {
+    auto const display = SDL_GetDisplayForWindow(window);
+    auto const *mode = display == 0 ? nullptr : SDL_GetCurrentDisplayMode(display);
+    if (mode == nullptr || mode->refresh_rate <= 0.0f) {
+        logger->warn("unknown display refresh rate, assuming {} hz", target_fps);
+        return static_cast<float>(target_fps);
+    }
+
+    return mode->refresh_rate;
+}
+} // namespace
+
+FramePacer::FramePacer(SDL_Window *window, unsigned int divisor)
+    : frame_budget_ns(0), deadline_ns(0), last_frame_end_ns(0), vsync_enabled(false), adaptive_vsync(false),
+      logger(get_or_create_stdout_logger("frame_pacer")) {
+    divisor = std::max(divisor, 1U);
+    auto const refresh_rate = ::display_refresh_rate(window, logger);
+    frame_budget_ns = static_cast<uint64_t>(1e9 * static_cast<double>(divisor) / static_cast<double>(refresh_rate));
+
+    // negative intervals are adaptive vsync, late frames swap immediately instead of waiting another refresh
+    auto const interval = static_cast<int>(divisor);
+    if (SDL_GL_SetSwapInterval(-interval)) {
+        vsync_enabled = true;
+        adaptive_vsync = true;
+    }
+    else if (SDL_GL_SetSwapInterval(interval)) {
+        vsync_enabled = true;
+    }
+    else {
+        logger->warn("vsync unavailable: {}", SDL_GetError());
+    }
+
+    logger->info("pacing to {0:.2f} hz / {1}, vsync {2}", refresh_rate, divisor,
+                 adaptive_vsync ? "adaptive" : (vsync_enabled ? "on" : "off"));
+
+    last_frame_end_ns = SDL_GetTicksNS();
+    deadline_ns = last_frame_end_ns + frame_budget_ns;
+}
+
+uint64_t FramePacer::get_frame_budget_ns() const noexcept {
+    return frame_budget_ns;
+}
+
+uint64_t FramePacer::get_deadline_ns() const noexcept {
+    return deadline_ns;
+}
+
+uint64_t FramePacer::remaining_ns() const {
+    auto const now_ns = SDL_GetTicksNS();
+    return now_ns >= deadline_ns ? 0 : deadline_ns - now_ns;
+}
+
+void FramePacer::end_frame(bool presented) {
+    auto now_ns = SDL_GetTicksNS();
+
+    if (presented && vsync_enabled) {
+        // the swap returned at a vblank so that is the phase to schedule from
+        deadline_ns = now_ns + frame_budget_ns - vsync_margin_ns;
+    }
+    else {
+        // only presented frames need an accurate wake up, idle frames just sleep
+        auto const spin_ns = presented ? spin_threshold_ns : 0;
+        if (now_ns + spin_ns < deadline_ns) {
+            SDL_DelayNS(deadline_ns - now_ns - spin_ns);
+        }
+
+        while ((now_ns = SDL_GetTicksNS()) < deadline_ns) {
+            // spin out the last stretch for an accurate wake up
+        }
+
+        // a frame that ran long starts a new schedule rather than rushing to catch up
+        deadline_ns = now_ns > deadline_ns + frame_budget_ns ? now_ns + frame_budget_ns : deadline_ns + frame_budget_ns;
+    }
+
+    stats.add(now_ns - last_frame_end_ns);
+    last_frame_end_ns = now_ns;
+}
+
+FrameTimeStats const &FramePacer::get_stats() const noexcept {
+    return stats;
+}
+
+bool FramePacer::is_adaptive_vsync() const noexcept {
+    return adaptive_vsync;
+}
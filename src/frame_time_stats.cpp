@@ -0,0 +1,53 @@
+#include "frame_time_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+FrameTimeStats::FrameTimeStats() : count(0), mean(0.0), m2(0.0), min(std::numeric_limits<uint64_t>::max()), max(0) {
+}
+
+void FrameTimeStats::add(uint64_t frame_time_ns) {
+    auto const value = static_cast<double>(frame_time_ns);
+
+    ++count;
+    auto const delta = value - mean;
+    mean += delta / static_cast<double>(count);
+    m2 += delta * (value - mean);
+
+    min = std::min(min, frame_time_ns);
+    max = std::max(max, frame_time_ns);
+}
+
+void FrameTimeStats::reset() {
+    *this = FrameTimeStats{};
+}
+
+uint64_t FrameTimeStats::get_count() const noexcept {
+    return count;
+}
+
+double FrameTimeStats::get_mean_ns() const noexcept {
+    return mean;
+}
+
+double FrameTimeStats::get_variance_ns2() const noexcept {
+    if (count < 2) {
+        return 0.0;
+    }
+
+    return m2 / static_cast<double>(count - 1);
+}
+
+double FrameTimeStats::get_stddev_ns() const noexcept {
+    return std::sqrt(get_variance_ns2());
+}
+
+uint64_t FrameTimeStats::get_min_ns() const noexcept {
+    return count == 0 ? 0 : min;
+}
+
+uint64_t FrameTimeStats::get_max_ns() const noexcept {
+    return max;
+}
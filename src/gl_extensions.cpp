@@ -0,0 +1,110 @@
+#include "gl_extensions.hpp"
+
+#include "glad/glad.h"
+
+#include <string_view>
+
+#include <SDL3/SDL.h>
+#include <spdlog/spdlog.h>
+
+using std::string_view;
+
+#ifdef OPENGL_ES
+static constexpr const bool is_opengl_es = true;
+#else
+static constexpr const bool is_opengl_es = false;
+#endif
+
+namespace {
+using MaxShaderCompilerThreadsProc = void(APIENTRYP)(GLuint count);
+using GetQueryObjectui64vProc = void(APIENTRYP)(GLuint id, GLenum pname, GLuint64 *params);
+
+/** let the driver decide how many threads to use */
+constexpr GLuint driver_chosen_thread_count = 0xFFFFFFFF;
+
+bool parallel_shader_compile_supported = false;
+
+/** glGetQueryObjectui64v or the EXT version on es, nullptr when unsupported */
+GetQueryObjectui64vProc get_query_object_ui64v_proc = nullptr;
+} // namespace
+
+bool has_gl_extension(string_view extension_name) {
+    GLint num_extensions = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &num_extensions);
+
+    for (GLint i = 0; i < num_extensions; ++i) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        auto const name = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+        if (name != nullptr && extension_name == name) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool init_parallel_shader_compile() {
+    const char *proc_name = nullptr;
+    if (has_gl_extension("GL_KHR_parallel_shader_compile")) {
+        proc_name = "glMaxShaderCompilerThreadsKHR";
+    }
+    else if (has_gl_extension("GL_ARB_parallel_shader_compile")) {
+        proc_name = "glMaxShaderCompilerThreadsARB";
+    }
+
+    if (proc_name == nullptr) {
+        spdlog::info("parallel shader compile not supported, shader status queries will block");
+        parallel_shader_compile_supported = false;
+        return false;
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto const max_shader_compiler_threads = reinterpret_cast<MaxShaderCompilerThreadsProc>(
+        SDL_GL_GetProcAddress(proc_name));
+    if (max_shader_compiler_threads != nullptr) {
+        max_shader_compiler_threads(driver_chosen_thread_count);
+    }
+
+    spdlog::info("using {} for parallel shader compile", proc_name);
+    parallel_shader_compile_supported = true;
+    return true;
+}
+
+bool is_parallel_shader_compile_supported() {
+    return parallel_shader_compile_supported;
+}
+
+bool init_gpu_timer_queries() {
+    if (!is_opengl_es) {
+        get_query_object_ui64v_proc = glGetQueryObjectui64v;
+        return true;
+    }
+
+    if (!has_gl_extension("GL_EXT_disjoint_timer_query")) {
+        spdlog::info("gpu timer queries not supported");
+        return false;
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    get_query_object_ui64v_proc =
+        reinterpret_cast<GetQueryObjectui64vProc>(SDL_GL_GetProcAddress("glGetQueryObjectui64vEXT"));
+    return get_query_object_ui64v_proc != nullptr;
+}
+
+bool are_gpu_timer_queries_supported() {
+    return get_query_object_ui64v_proc != nullptr;
+}
+
+void get_query_object_ui64v(GLuint query, GLenum pname, GLuint64 *params) {
+    get_query_object_ui64v_proc(query, pname, params);
+}
+
+bool was_gpu_timer_disjoint() {
+    if (!is_opengl_es) {
+        return false;
+    }
+
+    GLint disjoint = 0;
+    glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+    return disjoint != 0;
+}
@@ -3,6 +3,8 @@
 #include "glad/glad.h"
 
 #include <cassert>
+#include <cstddef>
+#include <initializer_list>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
@@ -82,3 +84,17 @@ std::optional<GLuint> get_max_tessellation_level() {
     return make_optional(static_cast<GLuint>(max_level));
 #endif
 }
+
+std::size_t count_gl_objects(GLuint max_name) {
+    std::size_t count = 0;
+    for (GLuint name = 1; name <= max_name; ++name) {
+        // every kind of object has names of its own, other than shaders and programs which share theirs
+        for (auto const is_object : {glIsBuffer(name), glIsVertexArray(name), glIsTexture(name),
+                                     glIsFramebuffer(name), glIsRenderbuffer(name), glIsQuery(name),
+                                     static_cast<GLboolean>(glIsShader(name) || glIsProgram(name))}) {
+            count += is_object == GL_TRUE ? 1 : 0;
+        }
+    }
+
+    return count;
+}
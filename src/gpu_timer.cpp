@@ -0,0 +1,83 @@
+#include "gpu_timer.hpp"
+#include "gl_extensions.hpp"
+
+#include "glad/glad.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+using std::nullopt;
+using std::optional;
+using std::size_t;
+
+GpuTimer::GpuTimer()
+    : queries{}, pending{}, next(0), running(false), supported(are_gpu_timer_queries_supported()) {
+    if (supported) {
+        glGenQueries(static_cast<GLsizei>(queries.size()), queries.data());
+    }
+}
+
+GpuTimer::~GpuTimer() {
+    if (supported) {
+        glDeleteQueries(static_cast<GLsizei>(queries.size()), queries.data());
+    }
+}
+
+void GpuTimer::begin() {
+    if (!supported || pending[next]) {
+        return;
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED_EXT, queries[next]);
+    running = true;
+}
+
+void GpuTimer::end() {
+    if (!running) {
+        return;
+    }
+
+    glEndQuery(GL_TIME_ELAPSED_EXT);
+    pending[next] = true;
+    next = (next + 1) % queries.size();
+    running = false;
+}
+
+optional<uint64_t> GpuTimer::collect() {
+    if (!supported) {
+        return nullopt;
+    }
+
+    optional<uint64_t> latest;
+
+    // oldest first so that latest ends up with the newest result
+    for (size_t offset = 0; offset < queries.size(); ++offset) {
+        auto const slot = (next + offset) % queries.size();
+        if (!pending[slot]) {
+            continue;
+        }
+
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available == GL_FALSE) {
+            continue;
+        }
+
+        GLuint64 elapsed_ns = 0;
+        get_query_object_ui64v(queries[slot], GL_QUERY_RESULT, &elapsed_ns);
+        pending[slot] = false;
+        latest = elapsed_ns;
+    }
+
+    // clock changes etc. make the results meaningless, reading the flag also resets it
+    if (was_gpu_timer_disjoint()) {
+        return nullopt;
+    }
+
+    return latest;
+}
+
+bool GpuTimer::is_supported() const noexcept {
+    return supported;
+}
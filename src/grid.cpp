@@ -1,28 +1,39 @@
 #include "grid.hpp"
 #include "es/grid_points.hpp"
-#include "tick_result.hpp"
 #include "vertices.hpp"
 
 #include "glad/glad.h"
 #include <SDL3/SDL.h>
 
+#include <memory>
 #include <variant>
 
 using std::holds_alternative;
 
-uint64_t Grid::render(TickResult tick_result) {
-    using std::get;
+void Grid::set_program(std::shared_ptr<ShaderProgram> const &shader_program) noexcept {
+    program = shader_program;
+}
 
-    if (tick_result.wireframe_display_mode_changed()) {
-        show_wireframe_only = !show_wireframe_only;
+bool Grid::is_wireframe_only() const noexcept {
+    return show_wireframe_only;
+}
+
+void Grid::set_wireframe_only(bool wireframe_only) {
+    if (wireframe_only == show_wireframe_only) {
+        return;
+    }
 
-        if (show_wireframe_only) {
-            glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-        }
-        else {
-            glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-        }
+    show_wireframe_only = wireframe_only;
+    if (show_wireframe_only) {
+        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
     }
+    else {
+        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    }
+}
+
+uint64_t Grid::render() {
+    using std::get;
 
     // TODO: convert to std::visit
     auto const start_nsec = SDL_GetTicksNS();
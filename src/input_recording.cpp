@@ -0,0 +1,328 @@
+#include "input_recording.hpp"
+#include "event_coalescer.hpp"
+#include "exceptions.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+using std::nullopt;
+using std::optional;
+using std::size_t;
+using std::span;
+using std::vector;
+
+/** start of every recording, followed by format_version */
+static constexpr const std::array<char, 4> magic = {'3', 'd', 'g', 'i'};
+static constexpr const uint32_t format_version = 1;
+
+/** recorded times only move by whole ms, see InputReplay */
+static constexpr const uint64_t ns_per_ms = 1'000'000;
+
+/** stands in for a tick that was never integrated, the clock is never 0 by the time input is read */
+static constexpr const uint64_t not_integrated = 0;
+
+namespace {
+template <typename T> void write_value(std::ostream &out, T value) {
+    std::array<char, sizeof(T)> bytes{};
+    std::memcpy(bytes.data(), &value, sizeof(T));
+    out.write(bytes.data(), bytes.size());
+}
+
+template <typename T> T read_value(std::istream &in) {
+    std::array<char, sizeof(T)> bytes{};
+    if (!in.read(bytes.data(), bytes.size())) {
+        throw InputError("input recording is cut short");
+    }
+
+    T value{};
+    std::memcpy(&value, bytes.data(), sizeof(T));
+    return value;
+}
+
+void write_event(std::ostream &out, SDL_Event const &event) {
+    ::write_value<uint32_t>(out, event.type);
+    ::write_value<uint64_t>(out, event.common.timestamp);
+
+    switch (event.type) {
+    case SDL_EVENT_KEY_DOWN:
+    case SDL_EVENT_KEY_UP:
+        ::write_value<uint32_t>(out, event.key.windowID);
+        ::write_value<uint32_t>(out, event.key.which);
+        ::write_value<uint32_t>(out, event.key.scancode);
+        ::write_value<uint32_t>(out, event.key.key);
+        ::write_value<uint16_t>(out, event.key.mod);
+        ::write_value<uint16_t>(out, event.key.raw);
+        ::write_value<uint8_t>(out, event.key.down ? 1 : 0);
+        ::write_value<uint8_t>(out, event.key.repeat ? 1 : 0);
+        break;
+    case SDL_EVENT_MOUSE_WHEEL:
+        ::write_value<uint32_t>(out, event.wheel.windowID);
+        ::write_value<uint32_t>(out, event.wheel.which);
+        ::write_value<float>(out, event.wheel.x);
+        ::write_value<float>(out, event.wheel.y);
+        ::write_value<uint32_t>(out, event.wheel.direction);
+        ::write_value<float>(out, event.wheel.mouse_x);
+        ::write_value<float>(out, event.wheel.mouse_y);
+        ::write_value<int32_t>(out, event.wheel.integer_x);
+        ::write_value<int32_t>(out, event.wheel.integer_y);
+        break;
+    case SDL_EVENT_MOUSE_MOTION:
+        ::write_value<uint32_t>(out, event.motion.windowID);
+        ::write_value<uint32_t>(out, event.motion.which);
+        ::write_value<uint32_t>(out, event.motion.state);
+        ::write_value<float>(out, event.motion.x);
+        ::write_value<float>(out, event.motion.y);
+        ::write_value<float>(out, event.motion.xrel);
+        ::write_value<float>(out, event.motion.yrel);
+        break;
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+    case SDL_EVENT_MOUSE_BUTTON_UP:
+        ::write_value<uint32_t>(out, event.button.windowID);
+        ::write_value<uint32_t>(out, event.button.which);
+        ::write_value<uint8_t>(out, event.button.button);
+        ::write_value<uint8_t>(out, event.button.down ? 1 : 0);
+        ::write_value<uint8_t>(out, event.button.clicks);
+        ::write_value<float>(out, event.button.x);
+        ::write_value<float>(out, event.button.y);
+        break;
+    default:
+        // EventLoop only looks at the type of anything else
+        break;
+    }
+}
+
+/**
+ * @return offset of the end of the stream, nullopt if it can't seek
+ */
+optional<std::streamoff> stream_end(std::istream &in) {
+    auto const position = in.tellg();
+    if (position < 0) {
+        return nullopt;
+    }
+
+    in.seekg(0, std::ios::end);
+    auto const end = in.tellg();
+    in.clear();
+    in.seekg(position);
+    return end < position ? nullopt : optional{static_cast<std::streamoff>(end)};
+}
+
+SDL_Event read_event(std::istream &in) {
+    SDL_Event event{};
+    event.type = ::read_value<uint32_t>(in);
+    event.common.timestamp = ::read_value<uint64_t>(in);
+
+    switch (event.type) {
+    case SDL_EVENT_KEY_DOWN:
+    case SDL_EVENT_KEY_UP:
+        event.key.windowID = ::read_value<uint32_t>(in);
+        event.key.which = ::read_value<uint32_t>(in);
+        event.key.scancode = static_cast<SDL_Scancode>(::read_value<uint32_t>(in));
+        event.key.key = ::read_value<uint32_t>(in);
+        event.key.mod = ::read_value<uint16_t>(in);
+        event.key.raw = ::read_value<uint16_t>(in);
+        event.key.down = ::read_value<uint8_t>(in) != 0;
+        event.key.repeat = ::read_value<uint8_t>(in) != 0;
+        break;
+    case SDL_EVENT_MOUSE_WHEEL:
+        event.wheel.windowID = ::read_value<uint32_t>(in);
+        event.wheel.which = ::read_value<uint32_t>(in);
+        event.wheel.x = ::read_value<float>(in);
+        event.wheel.y = ::read_value<float>(in);
+        event.wheel.direction = static_cast<SDL_MouseWheelDirection>(::read_value<uint32_t>(in));
+        event.wheel.mouse_x = ::read_value<float>(in);
+        event.wheel.mouse_y = ::read_value<float>(in);
+        event.wheel.integer_x = ::read_value<int32_t>(in);
+        event.wheel.integer_y = ::read_value<int32_t>(in);
+        break;
+    case SDL_EVENT_MOUSE_MOTION:
+        event.motion.windowID = ::read_value<uint32_t>(in);
+        event.motion.which = ::read_value<uint32_t>(in);
+        event.motion.state = ::read_value<uint32_t>(in);
+        event.motion.x = ::read_value<float>(in);
+        event.motion.y = ::read_value<float>(in);
+        event.motion.xrel = ::read_value<float>(in);
+        event.motion.yrel = ::read_value<float>(in);
+        break;
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+    case SDL_EVENT_MOUSE_BUTTON_UP:
+        event.button.windowID = ::read_value<uint32_t>(in);
+        event.button.which = ::read_value<uint32_t>(in);
+        event.button.button = ::read_value<uint8_t>(in);
+        event.button.down = ::read_value<uint8_t>(in) != 0;
+        event.button.clicks = ::read_value<uint8_t>(in);
+        event.button.x = ::read_value<float>(in);
+        event.button.y = ::read_value<float>(in);
+        break;
+    default:
+        break;
+    }
+
+    return event;
+}
+} // namespace
+
+InputRecording::InputRecording(uint64_t started_at_ns) : started_at_ns(started_at_ns) {
+}
+
+void InputRecording::begin_tick(uint64_t start_ns) {
+    ticks.push_back(RecordedTick{start_ns, nullopt, {}});
+}
+
+void InputRecording::add_batch(span<SDL_Event const> events) {
+    assert(!ticks.empty());
+    ticks.back().batches.emplace_back(events.begin(), events.end());
+}
+
+void InputRecording::end_tick(optional<uint64_t> integrated_until_ns) {
+    assert(!ticks.empty());
+    ticks.back().integrated_until_ns = integrated_until_ns;
+}
+
+uint64_t InputRecording::get_started_at_ns() const noexcept {
+    return started_at_ns;
+}
+
+vector<RecordedTick> const &InputRecording::get_ticks() const noexcept {
+    return ticks;
+}
+
+void InputRecording::write(std::ostream &out) const {
+    out.write(magic.data(), magic.size());
+    ::write_value<uint32_t>(out, format_version);
+    ::write_value<uint64_t>(out, started_at_ns);
+    ::write_value<uint64_t>(out, ticks.size());
+
+    for (auto const &tick : ticks) {
+        ::write_value<uint64_t>(out, tick.start_ns);
+        ::write_value<uint64_t>(out, tick.integrated_until_ns.value_or(not_integrated));
+        ::write_value<uint32_t>(out, static_cast<uint32_t>(tick.batches.size()));
+        for (auto const &batch : tick.batches) {
+            ::write_value<uint32_t>(out, static_cast<uint32_t>(batch.size()));
+            for (auto const &event : batch) {
+                ::write_event(out, event);
+            }
+        }
+    }
+}
+
+InputRecording InputRecording::read(std::istream &in) {
+    std::array<char, magic.size()> read_magic{};
+    if (!in.read(read_magic.data(), read_magic.size()) || read_magic != magic) {
+        throw InputError("not an input recording");
+    }
+
+    if (auto const version = ::read_value<uint32_t>(in); version != format_version) {
+        throw InputError(std::format("unsupported input recording version {}", version));
+    }
+
+    auto const end = ::stream_end(in);
+    InputRecording recording{::read_value<uint64_t>(in)};
+    auto const num_ticks = ::read_value<uint64_t>(in);
+    for (uint64_t i = 0; i < num_ticks; ++i) {
+        recording.begin_tick(::read_value<uint64_t>(in));
+        auto const integrated_until_ns = ::read_value<uint64_t>(in);
+
+        // the counts are checked before anything is sized by them, a corrupt file could ask for gigabytes.
+        // every batch takes at least its event count
+        auto const num_batches = ::read_value<uint32_t>(in);
+        auto const remaining = end.has_value() ? static_cast<uint64_t>(*end - in.tellg()) : UINT64_MAX;
+        if (uint64_t{num_batches} * sizeof(uint32_t) > remaining) {
+            throw InputError(std::format("input recording has {0} batches in a tick with {1} bytes left",
+                                         num_batches, remaining));
+        }
+
+        for (uint32_t j = 0; j < num_batches; ++j) {
+            auto const num_events = ::read_value<uint32_t>(in);
+            if (num_events > event_batch_size) {
+                throw InputError(std::format("input recording has a batch of {0} events, at most {1} are taken at once",
+                                             num_events, event_batch_size));
+            }
+
+            vector<SDL_Event> batch;
+            batch.reserve(num_events);
+            for (uint32_t k = 0; k < num_events; ++k) {
+                batch.push_back(::read_event(in));
+            }
+            recording.ticks.back().batches.push_back(std::move(batch));
+        }
+
+        recording.end_tick(integrated_until_ns == not_integrated ? nullopt : optional{integrated_until_ns});
+    }
+
+    return recording;
+}
+
+void InputRecording::save(std::filesystem::path const &path) const {
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    write(out);
+    out.flush();
+    if (!out) {
+        throw InputError(std::format("could not write input recording {}", path.string()));
+    }
+}
+
+InputRecording InputRecording::load(std::filesystem::path const &path) {
+    std::ifstream in{path, std::ios::binary};
+    if (!in) {
+        throw InputError(std::format("could not open input recording {}", path.string()));
+    }
+
+    return read(in);
+}
+
+InputReplay::InputReplay(InputRecording const &recording, uint64_t start_ns)
+    : ticks(recording.get_ticks()), next_tick(0),
+      offset_ns(start_ns / ns_per_ms * ns_per_ms - recording.get_started_at_ns() / ns_per_ms * ns_per_ms),
+      started_at_ns(recording.get_started_at_ns() + offset_ns), now_ns(started_at_ns) {
+}
+
+uint64_t InputReplay::get_started_at_ns() const noexcept {
+    return started_at_ns;
+}
+
+uint64_t InputReplay::get_now_ns() const noexcept {
+    return now_ns;
+}
+
+bool InputReplay::is_finished() const noexcept {
+    return next_tick >= ticks.size();
+}
+
+uint64_t InputReplay::get_next_due_ns() const {
+    assert(!is_finished());
+    auto const &tick = ticks[next_tick];
+    return tick.integrated_until_ns.value_or(tick.start_ns) + offset_ns;
+}
+
+RecordedTick InputReplay::next() {
+    assert(!is_finished());
+    auto tick = std::move(ticks[next_tick++]);
+
+    tick.start_ns += offset_ns;
+    if (tick.integrated_until_ns.has_value()) {
+        *tick.integrated_until_ns += offset_ns;
+    }
+    for (auto &batch : tick.batches) {
+        for (auto &event : batch) {
+            event.common.timestamp += offset_ns;
+        }
+    }
+
+    now_ns = tick.start_ns;
+    return tick;
+}
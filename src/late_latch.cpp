@@ -0,0 +1,39 @@
+#include "late_latch.hpp"
+#include "render_snapshot.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+#include <glm/ext/quaternion_trigonometric.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/vec3.hpp>
+
+using glm::angleAxis;
+using glm::mat4;
+using glm::quat;
+using glm::vec3;
+
+static const constexpr vec3 x_axis = vec3(1.0f, 0.0f, 0.0f);
+static const constexpr vec3 y_axis = vec3(0.0f, 1.0f, 0.0f);
+
+LateLatch::LateLatch(uint64_t max_ahead_ns) : max_ahead_ns(max_ahead_ns) {
+}
+
+mat4 LateLatch::model_at(RenderSnapshot const &snapshot, uint64_t now_ns) const {
+    if (!is_moving(snapshot) || now_ns <= snapshot.sampled_at_ns) {
+        return snapshot.model;
+    }
+
+    auto const ahead_ns = static_cast<float>(std::min(now_ns - snapshot.sampled_at_ns, max_ahead_ns));
+    auto const rads = snapshot.model_rotation_rads_per_ns * ahead_ns;
+
+    auto current = glm::quat_cast(snapshot.model);
+    current = angleAxis(rads.x, x_axis) * current;
+    current = angleAxis(rads.y, y_axis) * current;
+    return glm::mat4_cast(current);
+}
+
+bool LateLatch::is_moving(RenderSnapshot const &snapshot) noexcept {
+    return snapshot.model_rotation_rads_per_ns.x != 0.0f || snapshot.model_rotation_rads_per_ns.y != 0.0f;
+}
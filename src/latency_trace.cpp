@@ -0,0 +1,59 @@
+#include "latency_trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+using std::size_t;
+using std::string_view;
+using std::vector;
+
+void LatencyTrace::add(LatencyStage stage, uint64_t input_ns, uint64_t at_ns) {
+    if (at_ns < input_ns) {
+        return;
+    }
+
+    samples[static_cast<size_t>(stage)].push_back(at_ns - input_ns);
+}
+
+size_t LatencyTrace::get_count(LatencyStage stage) const noexcept {
+    return samples[static_cast<size_t>(stage)].size();
+}
+
+uint64_t LatencyTrace::get_percentile_ns(LatencyStage stage, double percent) const {
+    auto const &stage_samples = samples[static_cast<size_t>(stage)];
+    if (stage_samples.empty()) {
+        return 0;
+    }
+
+    // rank of the smallest sample with at least percent of the samples at or below it
+    auto const rank = static_cast<size_t>(
+        std::ceil(std::clamp(percent, 0.0, 100.0) / 100.0 * static_cast<double>(stage_samples.size())));
+    auto const index = std::max<size_t>(rank, 1) - 1;
+
+    vector<uint64_t> sorted{stage_samples};
+    std::ranges::nth_element(sorted, sorted.begin() + static_cast<std::ptrdiff_t>(index));
+    return sorted[index];
+}
+
+string_view LatencyTrace::get_stage_name(LatencyStage stage) noexcept {
+    switch (stage) {
+    case LatencyStage::processed:
+        return "processed";
+    case LatencyStage::published:
+        return "published";
+    case LatencyStage::uniforms_uploaded:
+        return "uniforms_uploaded";
+    case LatencyStage::submitted:
+        return "submitted";
+    case LatencyStage::swapped:
+        return "swapped";
+    case LatencyStage::gpu_complete:
+        return "gpu_complete";
+    }
+
+    return "unknown";
+}
@@ -1,13 +1,20 @@
 #include "glad/glad.h" // have to load glad first
 
 #include <array>
+#include <charconv>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <filesystem>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <stdexcept>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
 
 #include "spdlog/cfg/env.h"
 #include <SDL3/SDL.h>
@@ -21,18 +28,22 @@
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 
+#include "action_bindings.hpp"
 #include "consts.hpp"
-#include "es/cpu_tessellation.hpp"
-#include "es/grid_points.hpp"
 #include "event_loop.hpp"
+#include "exceptions.hpp"
+#include "expression.hpp"
+#include "frame_fences.hpp"
 #include "function_params.hpp"
-#include "grid.hpp"
-#include "max_deque.hpp"
+#include "gl_extensions.hpp"
+#include "input_recording.hpp"
 #include "opengl_debug_callback.hpp"
-#include "shader.hpp"
-#include "shader_program.hpp"
+#include "render_snapshot.hpp"
+#include "renderer.hpp"
+#include "shader_variants.hpp"
+#include "stress_input.hpp"
+#include "synthetic_input.hpp"
 #include "tessellation_settings.hpp"
-#include "vertices.hpp"
 
 using glm::mat4;
 using glm::perspective;
@@ -45,16 +56,16 @@ using std::array;
 using std::getenv;
 using std::initializer_list;
 using std::make_shared;
+using std::nullopt;
+using std::optional;
 using std::shared_ptr;
 using std::size_t;
 using std::string;
+using std::string_view;
 using std::stringstream;
-using std::to_array;
 using std::vector;
 using std::filesystem::path;
 
-static constexpr const GLint default_tessellation_level = 9;
-
 #ifdef OPENGL_ES
 static constexpr const bool is_opengl_es = true;
 #else
@@ -67,6 +78,304 @@ static constexpr const bool has_opengl_debug = true;
 static constexpr const bool has_opengl_debug = false;
 #endif
 
+/**
+ * SHADER_PRECISION=mediump selects the mediump shader variants, defaults to highp
+ */
+ShaderVariantKey initial_shader_variant_key() {
+    ShaderVariantKey key;
+    const auto precision_env_var = getenv("SHADER_PRECISION");
+    if (precision_env_var != nullptr && string{precision_env_var} == "mediump") {
+        key.precision = ShaderPrecision::mediump;
+    }
+
+    return key;
+}
+
+/**
+ * @return text as a number from min to max inclusive, nullopt if it is anything else. unlike std::stoull a
+ * leading - is rejected instead of wrapping around to a huge value
+ */
+optional<uint64_t> parse_in_range(string_view text, uint64_t min, uint64_t max) {
+    uint64_t value = 0;
+    auto const *const end = text.data() + text.size();
+    auto const [parsed_end, error] = std::from_chars(text.data(), end, value);
+    if (error != std::errc{} || parsed_end != end || value < min || value > max) {
+        return nullopt;
+    }
+
+    return value;
+}
+
+/** how often in ms to present a frame when nothing changed, see render_keep_alive_ms */
+static constexpr const uint64_t default_render_keep_alive_ms = 1000;
+
+/** an hour, anything longer is as good as never and only hides a typo */
+static constexpr const uint64_t max_render_keep_alive_ms = 3'600'000;
+
+/**
+ * RENDER_KEEP_ALIVE_MS is the longest to go without presenting a frame when nothing on screen changed,
+ * 0 renders every tick, at most an hour
+ */
+uint64_t render_keep_alive_ms(shared_ptr<spdlog::logger> const &err) {
+    const auto keep_alive_env_var = getenv("RENDER_KEEP_ALIVE_MS");
+    if (keep_alive_env_var == nullptr) {
+        return default_render_keep_alive_ms;
+    }
+
+    auto const keep_alive = parse_in_range(keep_alive_env_var, 0, max_render_keep_alive_ms);
+    if (!keep_alive.has_value()) {
+        err->error("invalid RENDER_KEEP_ALIVE_MS \"{0}\", expected 0 to {1}, using {2}", keep_alive_env_var,
+                   max_render_keep_alive_ms, default_render_keep_alive_ms);
+        return default_render_keep_alive_ms;
+    }
+
+    return *keep_alive;
+}
+
+/** rendering less often than every 8th refresh is not pacing any more */
+static constexpr const unsigned int max_frame_rate_divisor = 8;
+
+/**
+ * FRAME_RATE_DIVISOR=n renders every nth display refresh, 1 to 8, defaults to every refresh
+ */
+unsigned int frame_rate_divisor(shared_ptr<spdlog::logger> const &err) {
+    const auto divisor_env_var = getenv("FRAME_RATE_DIVISOR");
+    if (divisor_env_var == nullptr) {
+        return 1;
+    }
+
+    auto const divisor = parse_in_range(divisor_env_var, 1, max_frame_rate_divisor);
+    if (!divisor.has_value()) {
+        err->error("invalid FRAME_RATE_DIVISOR \"{0}\", expected 1 to {1}, rendering every refresh", divisor_env_var,
+                   max_frame_rate_divisor);
+        return 1;
+    }
+
+    return static_cast<unsigned int>(*divisor);
+}
+
+/**
+ * FRAMES_IN_FLIGHT=1 waits for the gpu to finish each frame before submitting the next (lowest latency),
+ * 2 lets the cpu get a frame ahead (more throughput)
+ */
+size_t frames_in_flight(shared_ptr<spdlog::logger> const &err) {
+    const auto frames_env_var = getenv("FRAMES_IN_FLIGHT");
+    if (frames_env_var == nullptr) {
+        return 1;
+    }
+
+    auto const frames = parse_in_range(frames_env_var, 1, FrameFences::max_frames_in_flight);
+    if (!frames.has_value()) {
+        err->error("invalid FRAMES_IN_FLIGHT \"{0}\", expected 1 to {1}, using 1", frames_env_var,
+                   FrameFences::max_frames_in_flight);
+        return 1;
+    }
+
+    return *frames;
+}
+
+/**
+ * LATENCY_TRACE=1 follows input event timestamps through to the gpu, percentiles per stage are logged on exit
+ */
+bool latency_trace_enabled() {
+    const auto trace_env_var = getenv("LATENCY_TRACE");
+    return trace_env_var != nullptr && string{trace_env_var} == "1";
+}
+
+/** spacing of the presses SYNTHETIC_INPUT makes, long enough for each to be drawn on its own */
+static constexpr const uint64_t synthetic_press_interval_ns = 100'000'000;
+static constexpr const uint64_t synthetic_hold_ns = 50'000'000;
+
+/** a day of presses, keeps the event count and the time of the quit well inside 64 bits */
+static constexpr const uint64_t max_synthetic_presses =
+    uint64_t{24} * 3600 * 1'000'000'000 / synthetic_press_interval_ns;
+
+/**
+ * SYNTHETIC_INPUT=n presses n keys on its own then quits, for measuring latency without a keyboard. at most a day
+ * of presses
+ */
+std::unique_ptr<SyntheticInput> synthetic_input(shared_ptr<spdlog::logger> const &err) {
+    const auto presses_env_var = getenv("SYNTHETIC_INPUT");
+    if (presses_env_var == nullptr) {
+        return nullptr;
+    }
+
+    auto const presses = parse_in_range(presses_env_var, 1, max_synthetic_presses);
+    if (!presses.has_value()) {
+        err->error("invalid SYNTHETIC_INPUT \"{0}\", expected 1 to {1}, not injecting input", presses_env_var,
+                   max_synthetic_presses);
+        return nullptr;
+    }
+
+    return std::make_unique<SyntheticInput>(static_cast<size_t>(*presses), synthetic_press_interval_ns,
+                                            synthetic_hold_ns);
+}
+
+/** how long STRESS_INPUT_RATE keeps going for when STRESS_INPUT_SECONDS is not set */
+static constexpr const uint64_t default_stress_input_seconds = 3600;
+
+/**
+ * a week of events at the highest rate, StressInput multiplies elapsed ns by the rate so the two together have to
+ * stay well inside 64 bits
+ */
+static constexpr const uint64_t max_stress_input_seconds = 7 * 24 * 3600;
+static constexpr const uint64_t max_stress_input_rate = 10'000;
+
+static constexpr const uint64_t default_stress_input_seed = 1;
+
+/**
+ * STRESS_INPUT_RATE=n floods the input with n random key, wheel and mouse events a second for
+ * STRESS_INPUT_SECONDS (default an hour) then quits. STRESS_INPUT_SEED (default 1) picks the events
+ */
+std::unique_ptr<StressInput> stress_input(shared_ptr<spdlog::logger> const &err) {
+    const auto rate_env_var = getenv("STRESS_INPUT_RATE");
+    if (rate_env_var == nullptr) {
+        return nullptr;
+    }
+
+    auto const rate = parse_in_range(rate_env_var, 1, max_stress_input_rate);
+    if (!rate.has_value()) {
+        err->error("invalid STRESS_INPUT_RATE \"{0}\", expected 1 to {1}, not injecting input", rate_env_var,
+                   max_stress_input_rate);
+        return nullptr;
+    }
+
+    auto seconds = default_stress_input_seconds;
+    if (const auto seconds_env_var = getenv("STRESS_INPUT_SECONDS"); seconds_env_var != nullptr) {
+        auto const parsed = parse_in_range(seconds_env_var, 1, max_stress_input_seconds);
+        if (parsed.has_value()) {
+            seconds = *parsed;
+        }
+        else {
+            err->error("invalid STRESS_INPUT_SECONDS \"{0}\", expected 1 to {1}, using {2}", seconds_env_var,
+                       max_stress_input_seconds, default_stress_input_seconds);
+        }
+    }
+
+    auto seed = default_stress_input_seed;
+    if (const auto seed_env_var = getenv("STRESS_INPUT_SEED"); seed_env_var != nullptr) {
+        auto const parsed = parse_in_range(seed_env_var, 0, std::numeric_limits<uint64_t>::max());
+        if (parsed.has_value()) {
+            seed = *parsed;
+        }
+        else {
+            err->error("invalid STRESS_INPUT_SEED \"{0}\", using {1}", seed_env_var, default_stress_input_seed);
+        }
+    }
+
+    return std::make_unique<StressInput>(*rate, seconds * 1'000'000'000, seed);
+}
+
+/** a day, the renderer takes the interval in ns so it has to stay far from 64 bits once multiplied up */
+static constexpr const uint64_t max_soak_report_interval_ms = 24 * 3600 * 1000;
+
+/**
+ * SOAK_REPORT_MS=n logs frame time drift, memory and gl object growth every n ms, up to a day. 0 (the default)
+ * never does
+ */
+uint64_t soak_report_interval_ms(shared_ptr<spdlog::logger> const &err) {
+    const auto interval_env_var = getenv("SOAK_REPORT_MS");
+    if (interval_env_var == nullptr) {
+        return 0;
+    }
+
+    auto const interval = parse_in_range(interval_env_var, 0, max_soak_report_interval_ms);
+    if (!interval.has_value()) {
+        err->error("invalid SOAK_REPORT_MS \"{0}\", expected 0 to {1}, not reporting", interval_env_var,
+                   max_soak_report_interval_ms);
+        return 0;
+    }
+
+    return *interval;
+}
+
+/**
+ * INPUT_RECORD=path records the input taken in to path on exit, INPUT_REPLAY=path feeds a recording back in
+ * place of the keyboard and mouse for comparing builds on the same input
+ */
+void set_input_recording(EventLoop &event_loop, shared_ptr<spdlog::logger> const &logger) {
+    const auto replay_env_var = getenv("INPUT_REPLAY");
+    if (replay_env_var != nullptr) {
+        event_loop.start_replay(InputRecording::load(replay_env_var));
+        logger->info("replaying input from {}", replay_env_var);
+        return;
+    }
+
+    if (getenv("INPUT_RECORD") != nullptr) {
+        event_loop.start_recording();
+    }
+}
+
+void save_input_recording(EventLoop const &event_loop, shared_ptr<spdlog::logger> const &logger) {
+    const auto record_env_var = getenv("INPUT_RECORD");
+    auto const &recording = event_loop.get_recording();
+    if (record_env_var == nullptr || !recording.has_value()) {
+        return;
+    }
+
+    recording->save(record_env_var);
+    logger->info("recorded {0} ticks of input to {1}", recording->get_ticks().size(), record_env_var);
+}
+
+/**
+ * KEY_BINDINGS=path rebinds the keys, see ActionBindings::parse. a file that does not load is logged and the
+ * default keys are used
+ */
+ActionBindings key_bindings(shared_ptr<spdlog::logger> const &err) {
+    const auto bindings_env_var = getenv("KEY_BINDINGS");
+    if (bindings_env_var == nullptr) {
+        return ActionBindings::defaults();
+    }
+
+    try {
+        return ActionBindings::load(bindings_env_var);
+    }
+    catch (InputError const &e) {
+        err->error("invalid KEY_BINDINGS \"{0}\": {1}, using the default keys", bindings_env_var, e.what());
+        return ActionBindings::defaults();
+    }
+}
+
+/** plotted when PLOT_FUNCTIONS is not set, ref: https://www.benjoffe.com/code/tools/functions3d/examples */
+static constexpr const char *default_plotted_function = "sin(10*(x^2+y^2))";
+
+/**
+ * PLOT_FUNCTIONS is a ; separated list of functions of x and y to cycle through, invalid ones are logged and skipped
+ */
+vector<CompiledExpression> plotted_functions(shared_ptr<spdlog::logger> const &err) {
+    const auto functions_env_var = getenv("PLOT_FUNCTIONS");
+    const string_view all_sources = functions_env_var == nullptr ? default_plotted_function : functions_env_var;
+
+    vector<CompiledExpression> functions;
+    size_t start = 0;
+    while (start <= all_sources.size()) {
+        auto end = all_sources.find(';', start);
+        if (end == string_view::npos) {
+            end = all_sources.size();
+        }
+
+        auto const source = all_sources.substr(start, end - start);
+        start = end + 1;
+        if (source.find_first_not_of(" \t") == string_view::npos) {
+            continue;
+        }
+
+        try {
+            functions.emplace_back(source);
+        }
+        catch (ExpressionError const &e) {
+            err->error("skipping plotted function \"{0}\": {1}", source, e.what());
+        }
+    }
+
+    if (functions.empty()) {
+        err->warn("no valid plotted functions, falling back to {}", default_plotted_function);
+        functions.emplace_back(default_plotted_function);
+    }
+
+    return functions;
+}
+
 void set_log_level() {
     const auto spdlog_env_var = getenv("SPDLOG_LEVEL");
     const auto log_level_env_var = getenv("LOG_LEVEL");
@@ -176,7 +485,6 @@ int main(int argc, char *argv[]) {
         init_opengl_debug();
     }
 
-    SDL_GL_SetSwapInterval(1); // vsync
     glDisable(GL_DEPTH_TEST);
     glEnable(GL_CULL_FACE);
     // glEnable(GL_PROGRAM_POINT_SIZE);
@@ -194,6 +502,9 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
+    init_parallel_shader_compile();
+    init_gpu_timer_queries();
+
     CPPTRACE_TRY {
         // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
         auto model = make_shared<mat4>(rotate(mat4(1.0f), radians(-90.0f), vec3(1.0f, 0.0f, 0.0f)));
@@ -204,86 +515,83 @@ int main(int argc, char *argv[]) {
         auto function_params = make_shared<FunctionParams>();
         auto tessellation_settings = make_shared<TessellationSettings>();
 
-        // TODO: clean this up
-        vector<shared_ptr<Shader>> the_shaders;
-        if (is_opengl_es) {
-            const path es_shader_base_path = "shaders/es";
-            the_shaders.push_back(make_shared<Shader>(es_shader_base_path / "vertex.glsl", GL_VERTEX_SHADER));
-            the_shaders.push_back(make_shared<Shader>(es_shader_base_path / "fragment.glsl", GL_FRAGMENT_SHADER));
+        RenderSnapshot snapshot{*model, *view, *projection, *function_params, tessellation_settings->get_level()};
+
+        // everything gl from here on is owned by the render thread
+        Renderer renderer{window,
+                          context,
+                          plotted_functions(stderr),
+                          initial_shader_variant_key(),
+                          snapshot,
+                          *tessellation_settings,
+                          render_keep_alive_ms(stderr),
+                          frame_rate_divisor(stderr),
+                          frames_in_flight(stderr),
+                          latency_trace_enabled(),
+                          soak_report_interval_ms(stderr)};
+        renderer.start();
+
+        EventLoop event_loop{model, view, projection, function_params, tessellation_settings, key_bindings(stderr)};
+        set_input_recording(event_loop, stdout);
+
+        // stopped before the renderer is destroyed
+        auto const injector = synthetic_input(stderr);
+        if (injector != nullptr) {
+            injector->start();
         }
-        else {
-            the_shaders.push_back(make_shared<Shader>("vertex.glsl", GL_VERTEX_SHADER));
-            the_shaders.push_back(make_shared<Shader>("tsc.glsl", GL_TESS_CONTROL_SHADER));
-            the_shaders.push_back(make_shared<Shader>("tes.glsl", GL_TESS_EVALUATION_SHADER));
-            the_shaders.push_back(make_shared<Shader>("fragment.glsl", GL_FRAGMENT_SHADER));
+        auto const stress = stress_input(stderr);
+        if (stress != nullptr) {
+            stress->start();
         }
 
-        auto const program = make_shared<ShaderProgram>(std::move(the_shaders), model, view, projection,
-                                                        function_params, tessellation_settings);
-
-        // TODO: new abstraction to handle VAO only for opengl 4.1 and VAO + IBO for opengl ES
-#ifdef OPENGL_ES
-        GridPoints verts{default_tessellation_level};
-#else
-        // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
-        Vertices verts{to_array<GLfloat>({0.5, -0.5, 0.0, 0.5, 0.5, 0.0, -0.5, 0.5, 0.0, -0.5, -0.5, 0.0}), (size_t)3};
-#endif
-
-        Grid grid{std::move(verts), program};
-
-        program->use();
-        program->set_initial_uniforms();
-        program->release();
-
-        // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
-        MaxDeque<uint64_t> render_timings(10);
-        EventLoop event_loop{model, view, projection, function_params, tessellation_settings};
+        // input is sampled at the display rate, independently of how long the render thread takes
+        auto const input_budget_ns = renderer.get_frame_budget_ns();
         while (true) {
-            auto const tick_result = event_loop.process_frame(render_timings.get_avg());
+            auto const tick_result = event_loop.process_frame(SDL_GetTicksNS() + input_budget_ns, 0);
+            auto const processed_ns = SDL_GetTicksNS();
+
+            // input that is not published changed nothing on screen, it is not traced
+            auto const input_timestamp_ns = event_loop.take_input_timestamp_ns();
             if (tick_result.should_exit()) {
+                save_input_recording(event_loop, stdout);
                 return 0;
             }
 
-            if (tick_result.frame_skip()) {
-                continue;
+            if (renderer.has_failed()) {
+                return 1;
             }
 
-            if (tick_result.any_uniforms_modified()) {
-                program->use();
-
-                if (tick_result.function_params_modified()) {
-                    program->update_function_params();
-                }
-
-                if (tick_result.view_modified()) {
-                    program->update_view();
-                }
-
-                if (tick_result.model_modified()) {
-                    program->update_model();
-                }
-
-                if (tick_result.tessellation_settings_modified()) {
-                    program->update_tessellation_settings();
-                }
-
-                program->release();
+            // a skipped tick still drained its events, a wheel zoom or expose among them needs publishing.
+            // so does letting go of a key, or the renderer would keep extrapolating the rotation
+            auto const model_rotation_rads_per_ns = event_loop.get_model_rotation_rads_per_ns();
+            if (!tick_result.needs_redraw() && model_rotation_rads_per_ns == snapshot.model_rotation_rads_per_ns) {
+                continue;
             }
 
-            glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-            glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
-
-            auto const start_render_tick = SDL_GetTicksNS();
-            grid.render(tick_result);
-            program->release();
+            snapshot.model = *model;
+            snapshot.sampled_at_ns = event_loop.get_integrated_until_ns();
+            snapshot.model_rotation_rads_per_ns = model_rotation_rads_per_ns;
+            snapshot.view = *view;
+            snapshot.projection = *projection;
+            snapshot.function_params = *function_params;
+            snapshot.tessellation_level = tessellation_settings->get_level();
 
-            SDL_GL_SwapWindow(window);
+            if (tick_result.wireframe_display_mode_changed()) {
+                snapshot.wireframe_only = !snapshot.wireframe_only;
+            }
 
-            render_timings.add(SDL_GetTicksNS() - start_render_tick);
+            if (tick_result.plotted_function_cycled()) {
+                snapshot.function_index = (snapshot.function_index + 1) % renderer.function_count();
+            }
 
-            if (max_sleep_ms_per_tick > tick_result.elapsed_ticks_ms) {
-                SDL_Delay(max_sleep_ms_per_tick - tick_result.elapsed_ticks_ms);
+            if (tick_result.redraw_requested()) {
+                ++snapshot.redraw_generation;
             }
+
+            snapshot.input_timestamp_ns = input_timestamp_ns;
+            snapshot.input_processed_ns = processed_ns;
+            snapshot.published_ns = SDL_GetTicksNS();
+            renderer.publish(snapshot);
         }
 
         return 0;
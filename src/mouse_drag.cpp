@@ -0,0 +1,105 @@
+#include "mouse_drag.hpp"
+#include "mouse_loc.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
+#include <SDL3/SDL.h>
+#include <glm/geometric.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+using glm::quat;
+using glm::vec2;
+using glm::vec3;
+using std::nullopt;
+using std::optional;
+
+/** below this the two points on the sphere are taken to be opposite, there is no one shortest rotation */
+static constexpr const float min_half_way = 1e-6f;
+
+namespace {
+/**
+ * @return the point on the unit sphere under the window position, points outside the sphere go to its rim
+ */
+vec3 to_sphere(MouseLoc at, vec2 window_size) {
+    auto const radius = std::min(window_size.x, window_size.y) / 2.0f;
+    auto const position = at.to_vec();
+
+    // window y goes down, view y goes up
+    vec2 const on_disc{(position.x - window_size.x / 2.0f) / radius, (window_size.y / 2.0f - position.y) / radius};
+    auto const length_squared = glm::dot(on_disc, on_disc);
+    if (length_squared > 1.0f) {
+        return vec3{on_disc / std::sqrt(length_squared), 0.0f};
+    }
+
+    return vec3{on_disc, std::sqrt(1.0f - length_squared)};
+}
+} // namespace
+
+MouseDrag::MouseDrag() : button(nullopt), from(0.0f, 0.0f), to(0.0f, 0.0f), released(false) {
+}
+
+void MouseDrag::press(Uint8 pressed, MouseLoc at) {
+    if (button.has_value()) {
+        return;
+    }
+
+    button = pressed;
+    from = at;
+    to = at;
+    released = false;
+}
+
+void MouseDrag::move(MouseLoc at) {
+    if (button.has_value() && !released) {
+        to = at;
+    }
+}
+
+void MouseDrag::release(Uint8 released_button, MouseLoc at) {
+    if (!button.has_value() || released || *button != released_button) {
+        return;
+    }
+
+    to = at;
+    released = true;
+}
+
+bool MouseDrag::is_dragging() const noexcept {
+    return button.has_value();
+}
+
+optional<DragDelta> MouseDrag::take() {
+    if (!button.has_value()) {
+        return nullopt;
+    }
+
+    optional<DragDelta> delta = nullopt;
+    if (from.to_vec() != to.to_vec()) {
+        delta = DragDelta{*button, from, to};
+        from = to;
+    }
+
+    if (released) {
+        button = nullopt;
+        released = false;
+    }
+
+    return delta;
+}
+
+quat arcball_rotation(MouseLoc from, MouseLoc to, vec2 window_size) {
+    auto const start = ::to_sphere(from, window_size);
+    auto const end = ::to_sphere(to, window_size);
+
+    // half way between the two is the axis and half the angle, normalized it is the shortest rotation
+    auto const half_way = 1.0f + glm::dot(start, end);
+    if (half_way < min_half_way) {
+        return quat{1.0f, 0.0f, 0.0f, 0.0f};
+    }
+
+    return glm::normalize(quat{half_way, glm::cross(start, end)});
+}
@@ -0,0 +1,74 @@
+#include "press_history.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+using std::nullopt;
+using std::optional;
+using std::size_t;
+
+void PressHistory::push(Press press) noexcept {
+    last_index = (last_index + 1) % capacity;
+    presses[last_index] = press;
+    count = std::min(count + 1, capacity);
+}
+
+void PressHistory::press(uint64_t now_ns) noexcept {
+    if (is_held()) {
+        return;
+    }
+
+    push({now_ns, still_held});
+}
+
+void PressHistory::release(uint64_t now_ns) noexcept {
+    if (count == 0) {
+        // original key press has been lost, make up key press start
+        push({now_ns, now_ns});
+        return;
+    }
+
+    if (is_held()) {
+        presses[last_index].end_ns = now_ns;
+    }
+}
+
+optional<Interval> PressHistory::last() const noexcept {
+    if (count == 0) {
+        return nullopt;
+    }
+
+    auto const &press = presses[last_index];
+    return Interval{press.start_ns, press.end_ns == still_held ? nullopt : optional{press.end_ns}};
+}
+
+uint64_t PressHistory::held_ns(uint64_t start_ns, uint64_t end_ns) const noexcept {
+    uint64_t held = 0;
+
+    // presses never overlap, so the overlap of each with the window adds up exactly
+    for (size_t i = 0; i < count; ++i) {
+        auto const &press = presses[(last_index + capacity - i) % capacity];
+        auto const from = std::max(press.start_ns, start_ns);
+        auto const to = std::min(press.end_ns, end_ns);
+        if (to > from) {
+            held += to - from;
+        }
+
+        if (press.start_ns <= start_ns) {
+            // everything older ended before the window
+            break;
+        }
+    }
+
+    return held;
+}
+
+bool PressHistory::is_held() const noexcept {
+    return count != 0 && presses[last_index].end_ns == still_held;
+}
+
+size_t PressHistory::size() const noexcept {
+    return count;
+}
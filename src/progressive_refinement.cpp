@@ -0,0 +1,33 @@
+#include "progressive_refinement.hpp"
+
+#include "glad/glad.h"
+
+#include <algorithm>
+
+ProgressiveRefinement::ProgressiveRefinement(GLuint coarse_level, GLuint initial_level)
+    : coarse_level(coarse_level), level(initial_level) {
+}
+
+GLuint ProgressiveRefinement::coarsen(GLuint target) noexcept {
+    level = std::min(coarse_level, target);
+    return level;
+}
+
+GLuint ProgressiveRefinement::refine(GLuint target) noexcept {
+    // doubling reaches any level in a handful of frames, each one a visible step up
+    level = level >= target ? target : std::min(target, level * 2);
+    return level;
+}
+
+GLuint ProgressiveRefinement::set_level(GLuint new_level) noexcept {
+    level = new_level;
+    return level;
+}
+
+bool ProgressiveRefinement::is_refined(GLuint target) const noexcept {
+    return level == target;
+}
+
+GLuint ProgressiveRefinement::get_level() const noexcept {
+    return level;
+}
@@ -0,0 +1,56 @@
+#include "quality_cascade.hpp"
+#include "quality_governor.hpp"
+
+#include "glad/glad.h"
+
+#include <cstdint>
+
+QualityCascade::QualityCascade(uint64_t frame_budget_ns, GLuint min_resolution_step, GLuint resolution_steps,
+                               GLuint min_tessellation_level, GLuint requested_tessellation_level)
+    : resolution(frame_budget_ns, min_resolution_step, resolution_steps),
+      tessellation(frame_budget_ns, min_tessellation_level, requested_tessellation_level) {
+}
+
+GLuint QualityCascade::set_requested_tessellation_level(GLuint level) {
+    return tessellation.set_requested_level(level);
+}
+
+QualityCascade::Change QualityCascade::add_frame_time(uint64_t frame_time_ns, FrameTessellation frame_tessellation) {
+    Change change;
+    if (frame_tessellation == FrameTessellation::none) {
+        change.resolution_step = resolution.add_frame_time(frame_time_ns);
+        return change;
+    }
+
+    // tessellation that was lowered comes back before the resolution does, cheap coarse frames would otherwise
+    // raise the resolution ahead of it
+    if (tessellation.get_level() < tessellation.get_requested_level()) {
+        if (frame_tessellation == FrameTessellation::governed) {
+            change.tessellation_level = tessellation.add_frame_time(frame_time_ns);
+        }
+        return change;
+    }
+
+    change.resolution_step = resolution.add_frame_time(frame_time_ns);
+
+    // at the minimum resolution the resolution governor can only go up, so over budget frames are left to
+    // tessellation. it is already at the requested level so it can only go down, they never both move
+    if (frame_tessellation == FrameTessellation::governed && !change.resolution_step.has_value() &&
+        resolution.get_level() == resolution.get_min_level()) {
+        change.tessellation_level = tessellation.add_frame_time(frame_time_ns);
+    }
+
+    return change;
+}
+
+GLuint QualityCascade::get_resolution_step() const noexcept {
+    return resolution.get_level();
+}
+
+GLuint QualityCascade::get_tessellation_level() const noexcept {
+    return tessellation.get_level();
+}
+
+GLuint QualityCascade::get_requested_tessellation_level() const noexcept {
+    return tessellation.get_requested_level();
+}
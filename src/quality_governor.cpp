@@ -0,0 +1,69 @@
+#include "quality_governor.hpp"
+#include "max_deque.hpp"
+
+#include "glad/glad.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+
+using std::nullopt;
+using std::optional;
+
+QualityGovernor::QualityGovernor(uint64_t frame_budget_ns, GLuint min_level, GLuint requested_level)
+    : frame_budget_ns(frame_budget_ns), min_level(min_level), requested_level(std::max(requested_level, min_level)),
+      level(this->requested_level), frame_times(window_frames) {
+}
+
+void QualityGovernor::reset_window() {
+    frame_times = MaxDeque<uint64_t>(window_frames);
+}
+
+GLuint QualityGovernor::set_requested_level(GLuint new_requested_level) {
+    new_requested_level = std::max(new_requested_level, min_level);
+    if (new_requested_level != requested_level) {
+        requested_level = new_requested_level;
+        level = requested_level;
+        reset_window();
+    }
+
+    return level;
+}
+
+optional<GLuint> QualityGovernor::add_frame_time(uint64_t frame_time_ns) {
+    frame_times.add(frame_time_ns);
+    if (frame_times.size() < window_frames) {
+        return nullopt;
+    }
+
+    auto const avg_ns = static_cast<double>(frame_times.get_avg());
+    auto const budget_ns = static_cast<double>(frame_budget_ns);
+
+    auto new_level = level;
+    if (avg_ns > budget_ns * lower_above_budget && level > min_level) {
+        new_level = std::max(min_level, level - std::max(1U, level / 4U));
+    }
+    else if (avg_ns < budget_ns * raise_below_budget && level < requested_level) {
+        new_level = level + 1;
+    }
+
+    if (new_level == level) {
+        return nullopt;
+    }
+
+    level = new_level;
+    reset_window();
+    return level;
+}
+
+GLuint QualityGovernor::get_level() const noexcept {
+    return level;
+}
+
+GLuint QualityGovernor::get_requested_level() const noexcept {
+    return requested_level;
+}
+
+GLuint QualityGovernor::get_min_level() const noexcept {
+    return min_level;
+}
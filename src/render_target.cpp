@@ -0,0 +1,88 @@
+#include "render_target.hpp"
+#include "exceptions.hpp"
+
+#include "glad/glad.h"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+
+/** below this the frame is mostly blur */
+static constexpr const float min_scale = 0.1f;
+
+RenderTarget::RenderTarget(GLsizei window_width, GLsizei window_height)
+    : framebuffer(0), color(0), window_width(window_width), window_height(window_height), width(0), height(0),
+      scale(1.0f) {
+    glGenFramebuffers(1, &framebuffer);
+    glGenRenderbuffers(1, &color);
+}
+
+RenderTarget::~RenderTarget() {
+    glDeleteRenderbuffers(1, &color);
+    glDeleteFramebuffers(1, &framebuffer);
+}
+
+GLsizei RenderTarget::scaled_width() const noexcept {
+    return std::max(1, static_cast<GLsizei>(std::lround(static_cast<float>(window_width) * scale)));
+}
+
+GLsizei RenderTarget::scaled_height() const noexcept {
+    return std::max(1, static_cast<GLsizei>(std::lround(static_cast<float>(window_height) * scale)));
+}
+
+void RenderTarget::resize() {
+    width = scaled_width();
+    height = scaled_height();
+
+    glBindRenderbuffer(GL_RENDERBUFFER, color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+    auto const status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        throw WrappedOpenGLError(std::format("render target {0}x{1} incomplete: {2:#x}", width, height, status));
+    }
+}
+
+void RenderTarget::set_scale(float new_scale) {
+    scale = std::clamp(new_scale, min_scale, 1.0f);
+}
+
+void RenderTarget::begin() {
+    if (!is_scaled()) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, window_width, window_height);
+        return;
+    }
+
+    // storage is only reallocated when the scale actually changed the size
+    if (width != scaled_width() || height != scaled_height()) {
+        resize();
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, width, height);
+}
+
+void RenderTarget::end() {
+    if (!is_scaled()) {
+        return;
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, window_width, window_height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+float RenderTarget::get_scale() const noexcept {
+    return scale;
+}
+
+bool RenderTarget::is_scaled() const noexcept {
+    return scale < 1.0f;
+}
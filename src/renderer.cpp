@@ -0,0 +1,515 @@
+#include "renderer.hpp"
+#include "es/grid_points.hpp"
+#include "exceptions.hpp"
+#include "expression.hpp"
+#include "frame_fences.hpp"
+#include "frame_pacer.hpp"
+#include "function_params.hpp"
+#include "gl_inspect.hpp"
+#include "gpu_timer.hpp"
+#include "grid.hpp"
+#include "late_latch.hpp"
+#include "latency_trace.hpp"
+#include "logging.hpp"
+#include "consts.hpp"
+#include "render_snapshot.hpp"
+#include "render_target.hpp"
+#include "shader.hpp"
+#include "shader_program.hpp"
+#include "shader_variants.hpp"
+#include "soak_monitor.hpp"
+#include "tessellation_settings.hpp"
+#include "vertices.hpp"
+
+#include "glad/glad.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <cpptrace/from_current.hpp>
+#include <glm/mat4x4.hpp>
+#include <spdlog/spdlog.h>
+
+using glm::mat4;
+using std::make_shared;
+using std::shared_ptr;
+using std::size_t;
+using std::to_array;
+using std::vector;
+
+static constexpr const GLint default_tessellation_level = 9;
+
+/** the tessellation governor will not go below this */
+static constexpr const GLuint min_tessellation_level = 1;
+
+/** tessellation level drawn while the plot is moving, see ProgressiveRefinement */
+static constexpr const GLuint coarse_tessellation_level = 2;
+
+/** the resolution governor works in steps of 1 / resolution_steps of the window resolution on each axis */
+static constexpr const GLuint resolution_steps = 8;
+
+/** half the resolution on each axis, a quarter of the pixels */
+static constexpr const GLuint min_resolution_step = 4;
+
+/** the model is not extrapolated further ahead of the last snapshot than this many frames */
+static constexpr const uint64_t max_latch_ahead_frames = 2;
+
+/** gl object names probed for leaks in soak reports, well above what a session should ever use */
+static constexpr const GLuint max_probed_gl_name = 4096;
+
+static constexpr const uint64_t ns_per_ms = 1'000'000;
+
+/** how many gpu frame timings to average */
+static constexpr const size_t num_gpu_timings_maintain = 10;
+
+namespace {
+
+// TODO: new abstraction to handle VAO only for opengl 4.1 and VAO + IBO for opengl ES
+#ifdef OPENGL_ES
+GridPoints make_verts() {
+    return GridPoints{default_tessellation_level};
+}
+#else
+Vertices make_verts() {
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
+    return Vertices{to_array<GLfloat>({0.5, -0.5, 0.0, 0.5, 0.5, 0.0, -0.5, 0.5, 0.0, -0.5, -0.5, 0.0}), (size_t)3};
+}
+#endif
+
+ShaderVariants make_shader_variants(shared_ptr<mat4> const &model, shared_ptr<mat4> const &view,
+                                    shared_ptr<mat4> const &projection,
+                                    shared_ptr<FunctionParams> const &function_params,
+                                    shared_ptr<TessellationSettings> const &tessellation_settings,
+                                    vector<CompiledExpression> const &functions) {
+    ShaderVariants shader_variants{model, view, projection, function_params, tessellation_settings};
+    for (auto const &function : functions) {
+        shader_variants.add_function(function);
+    }
+
+    return shader_variants;
+}
+} // namespace
+
+Renderer::Renderer(SDL_Window *window, SDL_GLContext context, vector<CompiledExpression> &&functions,
+                   ShaderVariantKey initial_variant_key, RenderSnapshot const &initial_snapshot,
+                   TessellationSettings const &tessellation_settings, uint64_t keep_alive_ms,
+                   unsigned int frame_rate_divisor, size_t frames_in_flight, bool trace_input_latency,
+                   uint64_t soak_report_interval_ms)
+    : window(window), context(context), model(make_shared<mat4>(initial_snapshot.model)),
+      view(make_shared<mat4>(initial_snapshot.view)), projection(make_shared<mat4>(initial_snapshot.projection)),
+      function_params(make_shared<FunctionParams>(initial_snapshot.function_params)),
+      tessellation_settings(make_shared<TessellationSettings>(tessellation_settings)),
+      functions(std::move(functions)),
+      shader_variants(::make_shader_variants(model, view, projection, function_params, this->tessellation_settings,
+                                             this->functions)),
+      variant_key(initial_variant_key.with_function_hash(this->functions[initial_snapshot.function_index].get_hash())),
+      // shaders are only submitted here, the driver compiles them while the rest of startup runs
+      program(shader_variants.get(variant_key)), grid(::make_verts(), program),
+      shader_watcher(Shader::override_dir()), frame_pacer(window, frame_rate_divisor),
+      frame_fences(frames_in_flight), gpu_timings(num_gpu_timings_maintain),
+      render_target(window_w, window_h),
+      quality(frame_pacer.get_frame_budget_ns(), min_resolution_step, resolution_steps, min_tessellation_level,
+              initial_snapshot.tessellation_level),
+      refinement(coarse_tessellation_level, quality.get_tessellation_level()),
+      late_latch(max_latch_ahead_frames * frame_pacer.get_frame_budget_ns()), model_latched(false),
+      latency_trace(trace_input_latency ? std::make_optional<LatencyTrace>() : std::nullopt), traced_input_ns(0),
+      latency_fence(nullptr), fenced_input_ns(0),
+      soak_monitor(soak_report_interval_ms == 0
+                       ? std::nullopt
+                       : std::make_optional<SoakMonitor>(soak_report_interval_ms * ns_per_ms, SDL_GetTicksNS())),
+      keep_alive_ms(keep_alive_ms),
+      snapshots(initial_snapshot), failed(false), logger(get_or_create_stdout_logger("renderer")),
+      err(get_or_create_stderr_logger("renderer_err")) {
+    logger->info("plotting {}", this->functions[initial_snapshot.function_index].get_source());
+
+    // the wireframe toggle swaps fragment modes and F cycles functions, have them ready before they are needed
+    ahead_of_time.push_back(variant_key.with_fragment_mode(FragmentMode::wireframe));
+    for (auto const &function : this->functions) {
+        if (function.get_hash() != variant_key.function_hash) {
+            ahead_of_time.push_back(variant_key.with_function_hash(function.get_hash()));
+        }
+    }
+    shader_variants.queue(ahead_of_time);
+}
+
+Renderer::~Renderer() {
+    if (thread.joinable()) {
+        thread.request_stop();
+        thread.join();
+    }
+
+    // the gl objects are deleted on this thread
+    SDL_GL_MakeCurrent(window, context);
+    if (latency_fence != nullptr) {
+        glDeleteSync(latency_fence);
+    }
+}
+
+void Renderer::start() {
+    // a context can only be current on one thread at a time
+    SDL_GL_MakeCurrent(window, nullptr);
+    thread = std::jthread{[this](std::stop_token stop_token) { run(std::move(stop_token)); }};
+}
+
+void Renderer::publish(RenderSnapshot const &snapshot) {
+    snapshots.publish(snapshot);
+}
+
+bool Renderer::has_failed() const noexcept {
+    return failed.load(std::memory_order_acquire);
+}
+
+uint64_t Renderer::get_frame_budget_ns() const noexcept {
+    return frame_pacer.get_frame_budget_ns();
+}
+
+size_t Renderer::function_count() const noexcept {
+    return functions.size();
+}
+
+void Renderer::switch_program(ShaderVariantKey key) {
+    variant_key = key;
+    program = shader_variants.get(variant_key);
+
+    // uniforms are per program so the newly selected variant may be stale
+    program->use();
+    program->set_initial_uniforms();
+    program->release();
+    grid.set_program(program);
+}
+
+bool Renderer::apply(RenderSnapshot const &snapshot) {
+    auto const first = !applied.has_value();
+    auto const changed = [&](auto const member) { return first || applied.value().*member != snapshot.*member; };
+
+    *model = snapshot.model;
+    *view = snapshot.view;
+    *projection = snapshot.projection;
+    *function_params = snapshot.function_params;
+
+    // a level the user picked is shown as is, anything else moving is drawn coarse until it stops
+    auto const target = quality.set_requested_tessellation_level(snapshot.tessellation_level);
+    bool const moving = changed(&RenderSnapshot::function_params) || changed(&RenderSnapshot::model) ||
+                        changed(&RenderSnapshot::view) || changed(&RenderSnapshot::function_index);
+    if (first || changed(&RenderSnapshot::tessellation_level)) {
+        refinement.set_level(target);
+    }
+    else if (moving && tessellation_settings->is_hardware_tessellation_supported()) {
+        refinement.coarsen(target);
+    }
+    bool const level_changed = tessellation_settings->get_level() != refinement.get_level();
+    tessellation_settings->set_level(refinement.get_level());
+
+    auto next_key = variant_key;
+    if (changed(&RenderSnapshot::wireframe_only)) {
+        grid.set_wireframe_only(snapshot.wireframe_only);
+        next_key = next_key.with_fragment_mode(snapshot.wireframe_only ? FragmentMode::wireframe
+                                                                       : FragmentMode::checkerboard);
+    }
+
+    if (changed(&RenderSnapshot::function_index)) {
+        auto const &function = functions[snapshot.function_index % functions.size()];
+        next_key = next_key.with_function_hash(function.get_hash());
+        if (!first) {
+            logger->info("plotting {}", function.get_source());
+        }
+    }
+
+    bool const uniforms_changed = changed(&RenderSnapshot::function_params) || changed(&RenderSnapshot::model) ||
+                                  changed(&RenderSnapshot::view) || changed(&RenderSnapshot::projection) ||
+                                  level_changed;
+
+    bool const screen_changed = uniforms_changed || changed(&RenderSnapshot::wireframe_only) ||
+                                changed(&RenderSnapshot::function_index) ||
+                                changed(&RenderSnapshot::redraw_generation);
+
+    trace_latency(LatencyStage::processed, snapshot.input_timestamp_ns, snapshot.input_processed_ns);
+    trace_latency(LatencyStage::published, snapshot.input_timestamp_ns, snapshot.published_ns);
+
+    // input that changed nothing on screen is never presented. snapshots superseded before being drawn are
+    // presented by the same frame, it is traced from the oldest
+    if ((screen_changed || LateLatch::is_moving(snapshot)) && traced_input_ns == 0) {
+        traced_input_ns = snapshot.input_timestamp_ns;
+    }
+
+    if (next_key != variant_key) {
+        // sets every uniform on the new program
+        switch_program(next_key);
+    }
+    else if (uniforms_changed) {
+        program->use();
+        program->set_initial_uniforms();
+        program->release();
+    }
+
+    applied = snapshot;
+    return screen_changed;
+}
+
+bool Renderer::govern_quality(uint64_t frame_time_ns) {
+    // the es grid is not tessellated on the gpu, only the resolution can go down there
+    auto frame_tessellation = FrameTessellation::none;
+    if (tessellation_settings->is_hardware_tessellation_supported()) {
+        frame_tessellation = refinement.is_refined(quality.get_tessellation_level()) ? FrameTessellation::governed
+                                                                                      : FrameTessellation::coarse;
+    }
+    auto const change = quality.add_frame_time(frame_time_ns, frame_tessellation);
+
+    if (change.resolution_step.has_value()) {
+        render_target.set_scale(static_cast<float>(*change.resolution_step) / static_cast<float>(resolution_steps));
+        logger->debug("render scale {} for frame time budget", render_target.get_scale());
+    }
+
+    if (change.tessellation_level.has_value()) {
+        logger->debug("tessellation level {0} for frame time budget (requested {1})", *change.tessellation_level,
+                      quality.get_requested_tessellation_level());
+        set_tessellation_level(refinement.set_level(*change.tessellation_level));
+    }
+
+    return change.resolution_step.has_value() || change.tessellation_level.has_value();
+}
+
+bool Renderer::refine() {
+    auto const target = quality.get_tessellation_level();
+    if (refinement.is_refined(target)) {
+        return false;
+    }
+
+    set_tessellation_level(refinement.refine(target));
+    return true;
+}
+
+void Renderer::set_tessellation_level(GLuint level) {
+    tessellation_settings->set_level(level);
+    program->use();
+    program->update_tessellation_settings();
+    program->release();
+}
+
+void Renderer::latch() {
+    if (snapshots.update()) {
+        apply(snapshots.read());
+    }
+
+    // once it stops moving the uniform still holds the last extrapolation, put the snapshot's model back
+    auto const &snapshot = applied.value();
+    bool const moving = LateLatch::is_moving(snapshot);
+    if (!moving && !model_latched) {
+        return;
+    }
+
+    *model = late_latch.model_at(snapshot, SDL_GetTicksNS());
+    program->use();
+    program->update_model();
+    program->release();
+    model_latched = moving;
+}
+
+void Renderer::trace_latency(LatencyStage stage, uint64_t input_ns, uint64_t at_ns) {
+    if (latency_trace.has_value() && input_ns != 0) {
+        latency_trace->add(stage, input_ns, at_ns);
+    }
+}
+
+void Renderer::poll_latency_fence() {
+    if (latency_fence == nullptr) {
+        return;
+    }
+
+    // polled once a frame, so completion is seen up to a frame late
+    auto const result = glClientWaitSync(latency_fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        return;
+    }
+
+    if (result != GL_WAIT_FAILED) {
+        trace_latency(LatencyStage::gpu_complete, fenced_input_ns, SDL_GetTicksNS());
+    }
+    glDeleteSync(latency_fence);
+    latency_fence = nullptr;
+}
+
+void Renderer::report_soak() {
+    auto const now_ns = SDL_GetTicksNS();
+    if (!soak_monitor.has_value() || !soak_monitor->is_interval_over(now_ns)) {
+        return;
+    }
+
+    soak_monitor->end_interval(now_ns, SoakMonitor::read_resident_bytes(), count_gl_objects(max_probed_gl_name));
+    logger->info("soak: {}", *soak_monitor);
+}
+
+void Renderer::poll_shader_reload() {
+    auto const changed = shader_watcher.poll_changed();
+    if (ShaderVariants::is_built_from(changed)) {
+        reloaded_sources.insert(reloaded_sources.end(), changed.begin(), changed.end());
+        try {
+            // a reload already in flight is superseded by the newer sources
+            reloaded_key = variant_key;
+            reloaded_program = shader_variants.recompile(reloaded_key);
+        }
+        catch (WrappedOpenGLError const &e) {
+            err->error("shader reload failed, keeping the current shaders: {}", e.what());
+            reloaded_program = nullptr;
+        }
+    }
+
+    if (reloaded_program == nullptr || !reloaded_program->is_link_complete()) {
+        return;
+    }
+
+    try {
+        // uniforms are applied before the swap so the first frame drawn with it is not stale
+        reloaded_program->use();
+        reloaded_program->set_initial_uniforms();
+        reloaded_program->release();
+
+        shader_variants.replace(reloaded_key, reloaded_program, reloaded_sources);
+        reloaded_sources.clear();
+        shader_variants.queue(ahead_of_time);
+        if (reloaded_key == variant_key) {
+            program = reloaded_program;
+            grid.set_program(program);
+        }
+
+        logger->info("reloaded shaders");
+    }
+    catch (WrappedOpenGLError const &e) {
+        err->error("shader reload failed, keeping the current shaders: {}", e.what());
+    }
+
+    reloaded_program = nullptr;
+}
+
+void Renderer::run(std::stop_token stop_token) {
+    CPPTRACE_TRY {
+        SDL_GL_MakeCurrent(window, context);
+
+        // first point that has to wait on the driver
+        auto const start_shader_wait_ns = SDL_GetTicksNS();
+        program->use();
+        logger->info("waited {} ms for shaders to finish compiling",
+                     static_cast<double>(SDL_GetTicksNS() - start_shader_wait_ns) / 1e6);
+        program->set_initial_uniforms();
+        program->release();
+
+        apply(snapshots.read());
+
+        uint64_t last_present_ms = 0;
+        uint64_t last_present_ns = 0;
+        bool first_frame_presented = false;
+        bool presented_last_frame = false;
+        while (!stop_token.stop_requested()) {
+            poll_latency_fence();
+
+            bool redraw = false;
+            if (auto const gpu_time_ns = gpu_timer.collect(); gpu_time_ns.has_value()) {
+                gpu_timings.add(*gpu_time_ns);
+                gpu_time_stats.add(*gpu_time_ns);
+                redraw = govern_quality(*gpu_time_ns);
+            }
+
+            bool const moved = snapshots.update() && apply(snapshots.read());
+            redraw = moved || redraw;
+
+            // the latched model keeps moving between snapshots
+            redraw = redraw || LateLatch::is_moving(applied.value());
+
+            // idle frames go to refining what was drawn coarse while moving
+            if (!moved) {
+                redraw = refine() || redraw;
+            }
+
+            auto const previous_program = program;
+            poll_shader_reload();
+            redraw = redraw || program != previous_program;
+
+            // nothing is drawn while the plot is static, other than a frame every keep alive interval
+            bool const keep_alive_due = keep_alive_ms == 0 || SDL_GetTicks() - last_present_ms >= keep_alive_ms;
+            bool const presented = !first_frame_presented || redraw || keep_alive_due;
+            if (presented) {
+                // the cpu side of this frame overlapped the gpu finishing earlier ones, now wait for room
+                frame_fences.wait_for_slot();
+
+                gpu_timer.begin();
+                render_target.begin();
+                glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+                glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
+
+                latch();
+                trace_latency(LatencyStage::uniforms_uploaded, traced_input_ns, SDL_GetTicksNS());
+                auto const submit_time_ns = grid.render();
+                trace_latency(LatencyStage::submitted, traced_input_ns, SDL_GetTicksNS());
+                program->release();
+                render_target.end();
+                gpu_timer.end();
+
+                if (!gpu_timer.is_supported()) {
+                    // cpu submission time is the best there is
+                    govern_quality(submit_time_ns);
+                }
+
+                SDL_GL_SwapWindow(window);
+                frame_fences.frame_submitted();
+                last_present_ms = SDL_GetTicks();
+
+                // frames drawn back to back, an idle gap says nothing about how long frames take
+                auto const present_ns = SDL_GetTicksNS();
+                if (soak_monitor.has_value() && presented_last_frame) {
+                    soak_monitor->add_frame_time(present_ns - last_present_ns);
+                }
+                last_present_ns = present_ns;
+
+                if (traced_input_ns != 0) {
+                    trace_latency(LatencyStage::swapped, traced_input_ns, SDL_GetTicksNS());
+
+                    // one traced frame in flight at a time, inputs presented meanwhile go without gpu_complete
+                    if (latency_trace.has_value() && latency_fence == nullptr) {
+                        latency_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                        fenced_input_ns = traced_input_ns;
+                    }
+                    traced_input_ns = 0;
+                }
+
+                if (!first_frame_presented) {
+                    // ticks start at SDL_Init
+                    logger->info("time to first frame: {} ms", static_cast<double>(SDL_GetTicksNS()) / 1e6);
+                    first_frame_presented = true;
+                }
+            }
+
+            // use leftover frame time to compile variants before they are needed, leaving room for the next frame
+            if (shader_variants.pending_count() > 0 && frame_pacer.remaining_ns() > gpu_timings.get_avg()) {
+                shader_variants.compile_next_pending();
+            }
+
+            report_soak();
+            presented_last_frame = presented;
+            frame_pacer.end_frame(presented);
+        }
+
+        logger->info("frame pacing: {}", frame_pacer.get_stats());
+        if (gpu_timer.is_supported()) {
+            logger->info("gpu time: {}", gpu_time_stats);
+        }
+        if (latency_trace.has_value()) {
+            logger->info("input latency: {}", *latency_trace);
+        }
+    }
+    CPPTRACE_CATCH(std::exception & e) {
+        err->error(e.what());
+        cpptrace::from_current_exception().print();
+        failed.store(true, std::memory_order_release);
+    }
+
+    SDL_GL_MakeCurrent(window, nullptr);
+}
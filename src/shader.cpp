@@ -1,21 +1,33 @@
 #include "shader.hpp"
 #include "exceptions.hpp"
+#include "gl_extensions.hpp"
 #include "gl_inspect.hpp"
+#include "logging.hpp"
 
 #include <cassert>
+#include <cstdlib>
 #include <filesystem>
 #include <format>
 #include <fstream>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 
 using std::format;
+using std::getenv;
+using std::make_optional;
 using std::make_unique;
+using std::nullopt;
+using std::optional;
 using std::shared_ptr;
 using std::string;
+using std::string_view;
+using std::vector;
 using std::filesystem::current_path;
 using std::filesystem::path;
 
@@ -47,9 +59,37 @@ string read_file(const string &source_fn) {
     return str;
 }
 
-void do_shader_compilation(GLuint shader_handle, GLenum shader_type, GLsizei number_of_sources,
-                           const GLint *source_lengths, const path &source_path,
-                           const shared_ptr<spdlog::logger> &logger, const shared_ptr<spdlog::logger> &err) {
+/**
+ * @return the shader file under SHADER_OVERRIDE_DIR that should be used instead of the embedded shader, if any
+ */
+optional<path> find_override_path(string_view shader_name) {
+    auto const override_dir = Shader::override_dir();
+    if (!override_dir.has_value()) {
+        return nullopt;
+    }
+
+    auto override_path = *override_dir / path{shader_name};
+    if (!std::filesystem::is_regular_file(override_path)) {
+        return nullopt;
+    }
+
+    return make_optional(override_path);
+}
+
+void check_readable_shader_file(const path &source_path, GLenum shader_type) {
+    if (!std::filesystem::exists(source_path)) {
+        throw ShaderError(format("no such file {}", source_path.string()), shader_type);
+    }
+    else if (std::filesystem::is_directory(source_path)) {
+        throw ShaderError(format("{} is a directory", source_path.string()), shader_type);
+    }
+}
+
+/**
+ * the sources are concatenated by opengl in order, so only the first one may have a #version directive
+ */
+void submit_shader_compilation(GLuint shader_handle, GLenum shader_type, const vector<string_view> &shader_sources,
+                               const shared_ptr<spdlog::logger> &logger) {
     // preconditions
 
     // TODO: relax this restriction with ES 3.2 or GL_EXT_tessellation_shader
@@ -64,19 +104,29 @@ void do_shader_compilation(GLuint shader_handle, GLenum shader_type, GLsizei num
         throw WrappedOpenGLError(format("precondition failed in shader ctor: {}", gl_get_error_string(current_error)));
     }
 
-    logger->debug("reading shader file {}", source_path.string());
-    if (!std::filesystem::exists(source_path)) {
-        throw ShaderError(format("no such file {}", source_path.string()), shader_type);
-    }
-    else if (std::filesystem::is_directory(source_path)) {
-        throw ShaderError(format("{} is a directory", source_path.string()), shader_type);
+    // embedded sources are not null terminated so always pass the lengths
+    vector<const GLchar *> source_data;
+    vector<GLint> source_lengths;
+    source_data.reserve(shader_sources.size());
+    source_lengths.reserve(shader_sources.size());
+    for (auto const source : shader_sources) {
+        source_data.push_back(source.data());
+        source_lengths.push_back(static_cast<GLint>(source.size()));
     }
 
-    string shader_source = ::read_file(source_path);
-    auto shader_handle_data = shader_source.data();
-    glShaderSource(shader_handle, number_of_sources, static_cast<GLchar **>(&shader_handle_data), source_lengths);
+    logger->trace("compiling {} sources", shader_sources.size());
+    glShaderSource(shader_handle, static_cast<GLsizei>(source_data.size()), source_data.data(),
+                   source_lengths.data());
+
+    // status is not queried here so that the driver can compile in the background
+    // see Shader::check_compiled
     glCompileShader(shader_handle);
+}
 
+/**
+ * blocks until the shader has finished compiling
+ */
+void check_shader_compilation(GLuint shader_handle, GLenum shader_type, const shared_ptr<spdlog::logger> &err) {
     GLint compiled = -1;
     glGetShaderiv(shader_handle, GL_COMPILE_STATUS, &compiled);
 
@@ -116,17 +166,52 @@ template <> struct std::formatter<Shader> {
 };
 
 Shader::Shader(const path &source_path, GLenum shader_type)
-    : shader_type(shader_type), shader_handle(glCreateShader(shader_type)),
-      logger(spdlog::stderr_color_mt(format("shader_{}", shader_type_to_string(shader_type)))),
-      err(spdlog::stderr_color_mt(format("shader_{}_err", shader_type_to_string(shader_type)))) {
+    : shader_type(shader_type), shader_handle(glCreateShader(shader_type)), compile_checked(false),
+      logger(get_or_create_stderr_logger(format("shader_{}", shader_type_to_string(shader_type)))),
+      err(get_or_create_stderr_logger(format("shader_{}_err", shader_type_to_string(shader_type)))) {
     if (source_path.is_absolute()) {
         throw ShaderError("must specify path relative to shaders directory", shader_type);
     }
     else {
         // TODO: a lot of sanitization here
-        ::do_shader_compilation(shader_handle, shader_type, number_of_sources, source_lengths,
-                                current_path() / source_path, logger, err);
+        auto const full_path = current_path() / source_path;
+        logger->debug("reading shader file {}", full_path.string());
+        ::check_readable_shader_file(full_path, shader_type);
+
+        auto const shader_source = ::read_file(full_path);
+        ::submit_shader_compilation(shader_handle, shader_type, {shader_source}, logger);
+    }
+}
+
+Shader::Shader(const EmbeddedShader &embedded_shader, GLenum shader_type)
+    : Shader(vector<string>{load_source(embedded_shader)}, shader_type) {
+}
+
+Shader::Shader(const vector<string> &sources, GLenum shader_type)
+    : shader_type(shader_type), shader_handle(glCreateShader(shader_type)), compile_checked(false),
+      logger(get_or_create_stderr_logger(format("shader_{}", shader_type_to_string(shader_type)))),
+      err(get_or_create_stderr_logger(format("shader_{}_err", shader_type_to_string(shader_type)))) {
+    ::submit_shader_compilation(shader_handle, shader_type, vector<string_view>{sources.cbegin(), sources.cend()},
+                                logger);
+}
+
+string Shader::load_source(const EmbeddedShader &embedded_shader) {
+    auto const override_path = ::find_override_path(embedded_shader.name);
+    if (override_path.has_value()) {
+        spdlog::info("overriding embedded shader {0} with {1}", embedded_shader.name, override_path->string());
+        return ::read_file(*override_path);
+    }
+
+    return string{embedded_shader.source};
+}
+
+optional<path> Shader::override_dir() {
+    auto const override_dir = getenv(override_dir_env_var);
+    if (override_dir == nullptr) {
+        return nullopt;
     }
+
+    return make_optional(path{override_dir});
 }
 
 Shader::Shader(const string &source_fn, GLenum shader_type) : Shader(path{"shaders"} / path{source_fn}, shader_type) {
@@ -139,6 +224,25 @@ Shader::~Shader() {
     glDeleteShader(shader_handle);
 }
 
+bool Shader::is_compile_complete() const {
+    if (compile_checked || !is_parallel_shader_compile_supported()) {
+        return true;
+    }
+
+    GLint completed = GL_FALSE;
+    glGetShaderiv(shader_handle, GL_COMPLETION_STATUS_KHR, &completed);
+    return completed == GL_TRUE;
+}
+
+void Shader::check_compiled() {
+    if (compile_checked) {
+        return;
+    }
+
+    ::check_shader_compilation(shader_handle, shader_type, err);
+    compile_checked = true;
+}
+
 GLenum Shader::get_shader_type() const noexcept {
     return shader_type;
 }
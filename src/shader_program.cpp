@@ -17,8 +17,10 @@
 
 #include "exceptions.hpp"
 #include "function_params.hpp"
+#include "gl_extensions.hpp"
 #include "gl_inspect.hpp"
 #include "glad/glad.h"
+#include "logging.hpp"
 #include "shader.hpp"
 #include "shader_program.hpp"
 #include "tessellation_settings.hpp"
@@ -37,8 +39,6 @@ using std::stringstream;
 using std::vector;
 
 void ShaderProgram::link_shaders() {
-    using std::make_unique;
-
     // preconditions
     assert(program_handle != 0);
 
@@ -53,7 +53,31 @@ void ShaderProgram::link_shaders() {
     for_each(attached_shaders.cbegin(), attached_shaders.cend(),
              [&](const shared_ptr<Shader> &shader) { glAttachShader(program_handle, shader->shader_handle); });
 
+    // status is not queried here so the driver can link in the background, see finish_link
     glLinkProgram(program_handle);
+}
+
+bool ShaderProgram::is_link_complete() const {
+    if (link_checked || !is_parallel_shader_compile_supported()) {
+        return true;
+    }
+
+    GLint completed = GL_FALSE;
+    glGetProgramiv(program_handle, GL_COMPLETION_STATUS_KHR, &completed);
+    return completed == GL_TRUE;
+}
+
+void ShaderProgram::finish_link() {
+    using std::make_unique;
+
+    if (link_checked) {
+        return;
+    }
+
+    // report compile errors from the shaders themselves rather than a generic link failure
+    for (auto const &shader : attached_shaders) {
+        shader->check_compiled();
+    }
 
     GLint linked = -1;
     glGetProgramiv(program_handle, GL_LINK_STATUS, &linked);
@@ -78,7 +102,8 @@ void ShaderProgram::link_shaders() {
     // progam has to be in use first https://stackoverflow.com/a/36416867
     glUseProgram(program_handle);
 
-    if ((current_error = glGetError()) != GL_NO_ERROR) {
+    auto current_error = glGetError();
+    if (current_error != GL_NO_ERROR) {
         throw WrappedOpenGLError(format("program issue: {}", gl_get_error_string(current_error)));
     }
 
@@ -98,15 +123,17 @@ void ShaderProgram::link_shaders() {
     }
 
     glUseProgram(0);
+    link_checked = true;
 }
 
 ShaderProgram::ShaderProgram(vector<shared_ptr<Shader>> &&shaders, shared_ptr<glm::mat4> const &model,
                              shared_ptr<glm::mat4> const &view, shared_ptr<glm::mat4> const &projection,
                              shared_ptr<FunctionParams> const &function_params,
                              shared_ptr<TessellationSettings> const &tessellation_settings)
-    : program_handle(glCreateProgram()), in_use(false), attached_shaders(std::move(shaders)), model(model), view(view),
-      projection(projection), function_params(function_params), tessellation_settings(tessellation_settings),
-      logger(spdlog::stderr_color_mt("shader_program")), err(spdlog::stderr_color_mt("shader_program_err")) {
+    : program_handle(glCreateProgram()), in_use(false), link_checked(false), attached_shaders(std::move(shaders)),
+      model(model), view(view), projection(projection), function_params(function_params),
+      tessellation_settings(tessellation_settings), logger(get_or_create_stderr_logger("shader_program")),
+      err(get_or_create_stderr_logger("shader_program_err")) {
     link_shaders();
 }
 
@@ -125,6 +152,8 @@ void ShaderProgram::use() {
         return;
     }
 
+    finish_link();
+
     auto current_error = glGetError();
 
     if (current_error != GL_NO_ERROR) {
@@ -0,0 +1,228 @@
+#include "shader_variants.hpp"
+#include "embedded_shader.hpp"
+#include "embedded_shaders.hpp"
+#include "exceptions.hpp"
+#include "expression.hpp"
+#include "function_params.hpp"
+#include "gl_extensions.hpp"
+#include "logging.hpp"
+#include "shader.hpp"
+#include "shader_program.hpp"
+#include "tessellation_settings.hpp"
+
+#include "glad/glad.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <format>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+#include <spdlog/spdlog.h>
+
+using glm::mat4;
+using std::format;
+using std::make_shared;
+using std::shared_ptr;
+using std::size_t;
+using std::span;
+using std::string;
+using std::vector;
+
+namespace {
+
+/**
+ * the embedded sources that are concatenated (after the variant preamble) to build one shader stage,
+ * the plotted function is spliced in between the helpers and main when the stage calls it
+ */
+struct StageSources {
+    GLenum shader_type;
+    vector<EmbeddedShader> helpers;
+    EmbeddedShader main;
+    bool calls_plotted_function = false;
+};
+
+#ifdef OPENGL_ES
+constexpr const char *version_directive = "#version 300 es\n";
+
+vector<StageSources> stage_sources() {
+    return {
+        StageSources{GL_VERTEX_SHADER, {embedded_shader("common.glsl")}, embedded_shader("es/vertex.glsl"), true},
+        StageSources{GL_FRAGMENT_SHADER, {}, embedded_shader("fragment.glsl")},
+    };
+}
+#else
+constexpr const char *version_directive = "#version 410 core\n";
+
+vector<StageSources> stage_sources() {
+    return {
+        StageSources{GL_VERTEX_SHADER, {}, embedded_shader("vertex.glsl")},
+        StageSources{GL_TESS_CONTROL_SHADER, {}, embedded_shader("tsc.glsl")},
+        StageSources{GL_TESS_EVALUATION_SHADER, {embedded_shader("common.glsl")}, embedded_shader("tes.glsl"), true},
+        StageSources{GL_FRAGMENT_SHADER, {}, embedded_shader("fragment.glsl")},
+    };
+}
+#endif
+} // namespace
+
+string ShaderVariantKey::to_defines() const {
+    auto const precision_name = precision == ShaderPrecision::highp ? "highp" : "mediump";
+    auto const fragment_mode_define =
+        fragment_mode == FragmentMode::checkerboard ? "FRAGMENT_MODE_CHECKERBOARD" : "FRAGMENT_MODE_WIREFRAME";
+
+    return format("#define PRECISION {0}\n#define {1}\nprecision {0} float;\n", precision_name, fragment_mode_define);
+}
+
+ShaderVariants::ShaderVariants(shared_ptr<mat4> const &model, shared_ptr<mat4> const &view,
+                               shared_ptr<mat4> const &projection, shared_ptr<FunctionParams> const &function_params,
+                               shared_ptr<TessellationSettings> const &tessellation_settings)
+    : model(model), view(view), projection(projection), function_params(function_params),
+      tessellation_settings(tessellation_settings), logger(get_or_create_stdout_logger("shader_variants")) {
+}
+
+shared_ptr<ShaderProgram> ShaderVariants::compile(ShaderVariantKey key) const {
+    logger->debug("compiling shader variant {}", key);
+
+    auto const function_source = function_sources.find(key.function_hash);
+    if (function_source == function_sources.end()) {
+        throw ShaderError(format("no plotted function registered for {}", key));
+    }
+
+    auto const preamble = string{version_directive} + key.to_defines();
+    vector<shared_ptr<Shader>> shaders;
+    for (auto const &stage : ::stage_sources()) {
+        vector<string> sources{preamble};
+        for (auto const &embedded : stage.helpers) {
+            sources.push_back(Shader::load_source(embedded));
+        }
+
+        if (stage.calls_plotted_function) {
+            sources.push_back(function_source->second);
+        }
+
+        sources.push_back(Shader::load_source(stage.main));
+        shaders.push_back(make_shared<Shader>(sources, stage.shader_type));
+    }
+
+    return make_shared<ShaderProgram>(std::move(shaders), model, view, projection, function_params,
+                                      tessellation_settings);
+}
+
+void ShaderVariants::touch_function(size_t function_hash) {
+    std::erase(recent_functions, function_hash);
+    recent_functions.push_front(function_hash);
+
+    while (recent_functions.size() > max_cached_functions) {
+        auto const evicted = recent_functions.back();
+        recent_functions.pop_back();
+        std::erase_if(pending, [&](auto const &key) { return key.function_hash == evicted; });
+
+        // programs still held elsewhere stay alive until released
+        auto const removed =
+            std::erase_if(programs, [&](auto const &entry) { return entry.first.function_hash == evicted; });
+        logger->debug("evicted {} shader variants of function {:x}", removed, evicted);
+    }
+}
+
+void ShaderVariants::add_function(CompiledExpression const &function) {
+    function_sources.insert({function.get_hash(), function.get_glsl()});
+}
+
+shared_ptr<ShaderProgram> ShaderVariants::get(ShaderVariantKey key) {
+    touch_function(key.function_hash);
+
+    auto const found = programs.find(key);
+    if (found != programs.end()) {
+        return found->second;
+    }
+
+    logger->debug("shader variant {} was not compiled ahead of time", key);
+    auto program = compile(key);
+    programs.insert({key, program});
+    std::erase(pending, key);
+
+    return program;
+}
+
+shared_ptr<ShaderProgram> ShaderVariants::recompile(ShaderVariantKey key) const {
+    return compile(key);
+}
+
+void ShaderVariants::replace(ShaderVariantKey key, shared_ptr<ShaderProgram> const &program,
+                             span<string const> changed_sources) {
+    if (is_built_from(changed_sources)) {
+        // the variants only differ in their defines and plotted function, so they all have the changed source
+        logger->debug("dropping {} shader variants built from older sources", programs.size());
+        programs.clear();
+    }
+
+    programs.insert_or_assign(key, program);
+}
+
+bool ShaderVariants::is_compiled(ShaderVariantKey key) const {
+    return programs.contains(key);
+}
+
+bool ShaderVariants::is_ready(ShaderVariantKey key) const {
+    auto const found = programs.find(key);
+    return found != programs.end() && found->second->is_link_complete();
+}
+
+void ShaderVariants::queue(vector<ShaderVariantKey> const &keys) {
+    for (auto const key : keys) {
+        if (is_compiled(key) || std::ranges::find(pending, key) != pending.end()) {
+            continue;
+        }
+
+        if (is_parallel_shader_compile_supported()) {
+            // the driver compiles in the background so submitting now costs next to nothing
+            programs.insert({key, compile(key)});
+        }
+        else {
+            pending.push_back(key);
+        }
+    }
+}
+
+bool ShaderVariants::compile_next_pending() {
+    if (pending.empty()) {
+        return false;
+    }
+
+    auto const key = pending.front();
+    pending.pop_front();
+
+    // without parallel compile support the driver blocks anyway, so take the hit now rather than on first use
+    auto program = compile(key);
+    program->finish_link();
+    programs.insert({key, program});
+    return true;
+}
+
+size_t ShaderVariants::pending_count() const noexcept {
+    return pending.size();
+}
+
+bool ShaderVariants::is_built_from(span<string const> shader_names) {
+    auto const is_source = [&](EmbeddedShader const &embedded) {
+        return std::ranges::find(shader_names, embedded.name) != shader_names.end();
+    };
+
+    return std::ranges::any_of(::stage_sources(), [&](StageSources const &stage) {
+        return is_source(stage.main) || std::ranges::any_of(stage.helpers, is_source);
+    });
+}
+
+vector<ShaderVariantKey> ShaderVariants::all_keys(size_t function_hash) {
+    vector<ShaderVariantKey> keys;
+    for (auto const precision : {ShaderPrecision::highp, ShaderPrecision::mediump}) {
+        for (auto const fragment_mode : {FragmentMode::checkerboard, FragmentMode::wireframe}) {
+            keys.push_back(ShaderVariantKey{precision, fragment_mode, function_hash});
+        }
+    }
+
+    return keys;
+}
@@ -0,0 +1,158 @@
+#include "shader_watcher.hpp"
+#include "logging.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <spdlog/spdlog.h>
+
+using std::optional;
+using std::string;
+using std::string_view;
+using std::vector;
+using std::filesystem::path;
+
+#ifdef __linux__
+namespace {
+
+/** editors save by writing in place or by moving a temporary file over the original */
+constexpr const uint32_t watched_events = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE;
+
+/**
+ * watch dir, remembering it by its path relative to the shader directory
+ */
+void add_watch(int inotify_fd, path const &shader_dir, path const &dir, std::unordered_map<int, path> &watched_dirs,
+               std::shared_ptr<spdlog::logger> const &err) {
+    auto const watch = inotify_add_watch(inotify_fd, dir.c_str(), watched_events);
+    if (watch < 0) {
+        err->error("unable to watch {0}: {1}", dir.string(), std::strerror(errno));
+        return;
+    }
+
+    watched_dirs.insert_or_assign(watch, dir.lexically_relative(shader_dir));
+}
+
+/**
+ * inotify watches are not recursive, so every subdirectory (e.g. es/) gets its own watch
+ */
+void add_watches(int inotify_fd, path const &shader_dir, std::unordered_map<int, path> &watched_dirs,
+                 std::shared_ptr<spdlog::logger> const &err) {
+    ::add_watch(inotify_fd, shader_dir, shader_dir, watched_dirs, err);
+
+    // the directory can change while it is walked, what could not be walked is logged and not watched
+    std::error_code error;
+    std::filesystem::recursive_directory_iterator entries{
+        shader_dir, std::filesystem::directory_options::skip_permission_denied, error};
+    for (; !error && entries != std::filesystem::recursive_directory_iterator{}; entries.increment(error)) {
+        std::error_code status_error;
+        if (entries->is_directory(status_error)) {
+            ::add_watch(inotify_fd, shader_dir, entries->path(), watched_dirs, err);
+        }
+    }
+
+    if (error) {
+        err->error("unable to look for shader directories under {0}: {1}", shader_dir.string(), error.message());
+    }
+}
+} // namespace
+#endif
+
+ShaderWatcher::ShaderWatcher(optional<path> const &shader_dir)
+    : inotify_fd(-1), logger(get_or_create_stdout_logger("shader_watcher")),
+      err(get_or_create_stderr_logger("shader_watcher_err")) {
+    if (!shader_dir.has_value()) {
+        return;
+    }
+
+    std::error_code error;
+    if (!std::filesystem::is_directory(*shader_dir, error)) {
+        err->error("not watching {0} for shader changes: {1}", shader_dir->string(),
+                   error ? error.message() : "not a directory");
+        return;
+    }
+
+#ifdef __linux__
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd < 0) {
+        err->error("inotify init failed: {}", std::strerror(errno));
+        return;
+    }
+
+    ::add_watches(inotify_fd, *shader_dir, watched_dirs, err);
+    logger->info("watching {} for shader changes", shader_dir->string());
+#else
+    logger->warn("shader reloading is only supported on linux");
+#endif
+}
+
+ShaderWatcher::~ShaderWatcher() {
+#ifdef __linux__
+    if (inotify_fd >= 0) {
+        close(inotify_fd);
+    }
+#endif
+}
+
+bool ShaderWatcher::is_watching() const noexcept {
+    return inotify_fd >= 0;
+}
+
+vector<string> ShaderWatcher::poll_changed() {
+    vector<string> changed;
+#ifdef __linux__
+    if (inotify_fd < 0) {
+        return changed;
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
+    alignas(inotify_event) std::array<char, 4096> buffer{};
+    while (true) {
+        auto const bytes_read = read(inotify_fd, buffer.data(), buffer.size());
+        if (bytes_read <= 0) {
+            // EAGAIN once drained
+            break;
+        }
+
+        std::size_t offset = 0;
+        while (offset < static_cast<std::size_t>(bytes_read)) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            auto const *event = reinterpret_cast<const inotify_event *>(buffer.data() + offset);
+            offset += sizeof(inotify_event) + event->len;
+
+            if (event->len == 0) {
+                continue;
+            }
+
+            auto const dir = watched_dirs.find(event->wd);
+            if (dir == watched_dirs.end() || !string_view{event->name}.ends_with(".glsl")) {
+                continue;
+            }
+
+            // the root is relative to itself as ".", which is not part of the name
+            auto name = (dir->second == "." ? path{event->name} : dir->second / event->name).generic_string();
+            if (std::ranges::find(changed, name) == changed.end()) {
+                logger->debug("shader {} changed", name);
+                changed.push_back(std::move(name));
+            }
+        }
+    }
+#endif
+
+    return changed;
+}
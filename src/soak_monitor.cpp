@@ -0,0 +1,90 @@
+#include "soak_monitor.hpp"
+#include "frame_time_stats.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+using std::nullopt;
+using std::optional;
+using std::size_t;
+
+SoakMonitor::SoakMonitor(uint64_t interval_ns, uint64_t start_ns)
+    : interval_ns(interval_ns), interval_start_ns(start_ns), num_intervals(0), baseline(nullopt), latest(nullopt) {
+}
+
+void SoakMonitor::add_frame_time(uint64_t frame_time_ns) {
+    frame_times.add(frame_time_ns);
+}
+
+bool SoakMonitor::is_interval_over(uint64_t now_ns) const noexcept {
+    return now_ns - interval_start_ns >= interval_ns;
+}
+
+void SoakMonitor::end_interval(uint64_t now_ns, optional<uint64_t> resident_bytes, size_t gl_objects) {
+    latest = SoakSample{frame_times, resident_bytes, gl_objects};
+    if (!baseline.has_value()) {
+        baseline = latest;
+    }
+
+    ++num_intervals;
+    frame_times.reset();
+    interval_start_ns = now_ns;
+}
+
+uint64_t SoakMonitor::get_interval_count() const noexcept {
+    return num_intervals;
+}
+
+optional<SoakSample> const &SoakMonitor::get_baseline() const noexcept {
+    return baseline;
+}
+
+optional<SoakSample> const &SoakMonitor::get_latest() const noexcept {
+    return latest;
+}
+
+double SoakMonitor::get_frame_time_drift_ns() const noexcept {
+    if (!latest.has_value()) {
+        return 0.0;
+    }
+
+    return latest->frame_times.get_mean_ns() - baseline->frame_times.get_mean_ns();
+}
+
+int64_t SoakMonitor::get_memory_growth_bytes() const noexcept {
+    if (!latest.has_value() || !latest->resident_bytes.has_value() || !baseline->resident_bytes.has_value()) {
+        return 0;
+    }
+
+    return static_cast<int64_t>(*latest->resident_bytes) - static_cast<int64_t>(*baseline->resident_bytes);
+}
+
+int64_t SoakMonitor::get_gl_object_growth() const noexcept {
+    if (!latest.has_value()) {
+        return 0;
+    }
+
+    return static_cast<int64_t>(latest->gl_objects) - static_cast<int64_t>(baseline->gl_objects);
+}
+
+optional<uint64_t> SoakMonitor::read_resident_bytes() {
+#ifdef __linux__
+    // total program size then resident size, both in pages
+    std::ifstream statm{"/proc/self/statm"};
+    uint64_t size_pages = 0;
+    uint64_t resident_pages = 0;
+    if (!(statm >> size_pages >> resident_pages)) {
+        return nullopt;
+    }
+
+    return resident_pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#else
+    return nullopt;
+#endif
+}
@@ -0,0 +1,190 @@
+#include "stress_input.hpp"
+#include "consts.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+using std::size_t;
+using std::vector;
+
+/** movement, zoom, wireframe and function keys, in the order of StressInput::held */
+static constexpr const std::array<SDL_Scancode, StressInput::num_keys> pressed_scan_codes = {
+    SDL_SCANCODE_W,      SDL_SCANCODE_A,     SDL_SCANCODE_S,    SDL_SCANCODE_D,
+    SDL_SCANCODE_UP,     SDL_SCANCODE_DOWN,  SDL_SCANCODE_LEFT, SDL_SCANCODE_RIGHT,
+    SDL_SCANCODE_EQUALS, SDL_SCANCODE_MINUS, SDL_SCANCODE_E,    SDL_SCANCODE_F,
+};
+
+/** out of 100 events, how many are keys. the rest are split between the mouse wheel, motion and buttons */
+static constexpr const uint64_t key_percent = 60;
+
+/** out of 100 key events on a held key, how many repeat rather than release it */
+static constexpr const uint64_t repeat_percent = 30;
+
+/** out of 100 key events, how many have shift held */
+static constexpr const uint64_t shift_percent = 25;
+
+/** furthest the mouse moves in one motion event on each axis, in pixels */
+static constexpr const uint64_t max_motion_px = 20;
+
+static constexpr const uint64_t ns_per_s = 1'000'000'000;
+
+StressInput::StressInput(uint64_t events_per_second, uint64_t duration_ns, uint64_t seed)
+    : events_per_second(std::max<uint64_t>(events_per_second, 1)), duration_ns(duration_ns), rng(seed),
+      button_held(false), mouse_x(static_cast<float>(window_w) / 2.0f),
+      mouse_y(static_cast<float>(window_h) / 2.0f) {
+}
+
+uint64_t StressInput::draw(uint64_t bound) {
+    // not a std distribution, those differ between standard libraries and the events would with them
+    return rng() % bound;
+}
+
+SDL_Event StressInput::next_event(uint64_t timestamp_ns) {
+    if (draw(100) < key_percent) {
+        return next_key_event(timestamp_ns);
+    }
+
+    return next_mouse_event(timestamp_ns);
+}
+
+SDL_Event StressInput::next_key_event(uint64_t timestamp_ns) {
+    auto const index = static_cast<size_t>(draw(num_keys));
+    auto const scan_code = pressed_scan_codes[index];
+    auto const mod = draw(100) < shift_percent ? SDL_KMOD_LSHIFT : SDL_KMOD_NONE;
+
+    SDL_Event event{};
+    bool const repeat = held.test(index) && draw(100) < repeat_percent;
+    bool const down = !held.test(index) || repeat;
+    held.set(index, down);
+
+    event.type = down ? SDL_EVENT_KEY_DOWN : SDL_EVENT_KEY_UP;
+    event.key.timestamp = timestamp_ns;
+    event.key.scancode = scan_code;
+    event.key.key = SDL_GetKeyFromScancode(scan_code, mod, true);
+    event.key.mod = mod;
+    event.key.down = down;
+    event.key.repeat = repeat;
+    return event;
+}
+
+SDL_Event StressInput::next_mouse_event(uint64_t timestamp_ns) {
+    SDL_Event event{};
+    auto const kind = draw(8);
+    if (kind < 3) {
+        event.type = SDL_EVENT_MOUSE_WHEEL;
+        event.wheel.timestamp = timestamp_ns;
+        event.wheel.integer_y = draw(2) == 0 ? 1 : -1;
+        event.wheel.y = static_cast<float>(event.wheel.integer_y);
+        event.wheel.mouse_x = mouse_x;
+        event.wheel.mouse_y = mouse_y;
+        return event;
+    }
+
+    if (kind < 7) {
+        auto const xrel = static_cast<float>(draw(max_motion_px * 2 + 1)) - static_cast<float>(max_motion_px);
+        auto const yrel = static_cast<float>(draw(max_motion_px * 2 + 1)) - static_cast<float>(max_motion_px);
+        mouse_x = std::clamp(mouse_x + xrel, 0.0f, static_cast<float>(window_w - 1));
+        mouse_y = std::clamp(mouse_y + yrel, 0.0f, static_cast<float>(window_h - 1));
+
+        event.type = SDL_EVENT_MOUSE_MOTION;
+        event.motion.timestamp = timestamp_ns;
+        event.motion.state = button_held ? SDL_BUTTON_LMASK : 0;
+        event.motion.x = mouse_x;
+        event.motion.y = mouse_y;
+        event.motion.xrel = xrel;
+        event.motion.yrel = yrel;
+        return event;
+    }
+
+    button_held = !button_held;
+    event.type = button_held ? SDL_EVENT_MOUSE_BUTTON_DOWN : SDL_EVENT_MOUSE_BUTTON_UP;
+    event.button.timestamp = timestamp_ns;
+    event.button.button = SDL_BUTTON_LEFT;
+    event.button.down = button_held;
+    event.button.clicks = 1;
+    event.button.x = mouse_x;
+    event.button.y = mouse_y;
+    return event;
+}
+
+vector<SDL_Event> StressInput::release_all(uint64_t timestamp_ns) {
+    vector<SDL_Event> released;
+    for (size_t i = 0; i < num_keys; ++i) {
+        if (!held.test(i)) {
+            continue;
+        }
+
+        SDL_Event event{};
+        event.type = SDL_EVENT_KEY_UP;
+        event.key.timestamp = timestamp_ns;
+        event.key.scancode = pressed_scan_codes[i];
+        event.key.key = SDL_GetKeyFromScancode(pressed_scan_codes[i], SDL_KMOD_NONE, true);
+        event.key.mod = SDL_KMOD_NONE;
+        released.push_back(event);
+    }
+    held.reset();
+
+    if (button_held) {
+        SDL_Event event{};
+        event.type = SDL_EVENT_MOUSE_BUTTON_UP;
+        event.button.timestamp = timestamp_ns;
+        event.button.button = SDL_BUTTON_LEFT;
+        event.button.x = mouse_x;
+        event.button.y = mouse_y;
+        released.push_back(event);
+        button_held = false;
+    }
+
+    return released;
+}
+
+void StressInput::start() {
+    thread = std::jthread{[this](std::stop_token stop_token) { run(std::move(stop_token)); }};
+}
+
+void StressInput::run(std::stop_token stop_token) {
+    auto const start_ns = SDL_GetTicksNS();
+    auto const end_ns = start_ns + duration_ns;
+
+    // events are due evenly spaced, whatever fell due while sleeping is pushed at once
+    uint64_t pushed = 0;
+    while (!stop_token.stop_requested()) {
+        auto const now_ns = SDL_GetTicksNS();
+        if (now_ns >= end_ns) {
+            break;
+        }
+
+        auto const due = (now_ns - start_ns) * events_per_second / ns_per_s + 1;
+        for (; pushed < due; ++pushed) {
+            auto event = next_event(now_ns);
+            SDL_PushEvent(&event);
+        }
+
+        auto const next_due_ns = start_ns + pushed * ns_per_s / events_per_second;
+        if (next_due_ns > now_ns) {
+            SDL_DelayNS(std::min(next_due_ns - now_ns, max_injector_sleep_ns));
+        }
+    }
+
+    if (stop_token.stop_requested()) {
+        return;
+    }
+
+    auto const now_ns = SDL_GetTicksNS();
+    for (auto &event : release_all(now_ns)) {
+        SDL_PushEvent(&event);
+    }
+
+    SDL_Event quit{};
+    quit.type = SDL_EVENT_QUIT;
+    quit.quit.timestamp = now_ns;
+    SDL_PushEvent(&quit);
+}
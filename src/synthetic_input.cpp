@@ -0,0 +1,81 @@
+#include "synthetic_input.hpp"
+#include "consts.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+#include <SDL3/SDL.h>
+
+using std::size_t;
+
+/** keys that move the plot, cycled through so every kind of movement is measured */
+static constexpr const std::array pressed_scan_codes = {
+    SDL_SCANCODE_W,  SDL_SCANCODE_D,     SDL_SCANCODE_S,    SDL_SCANCODE_A,
+    SDL_SCANCODE_UP, SDL_SCANCODE_RIGHT, SDL_SCANCODE_DOWN, SDL_SCANCODE_LEFT,
+};
+
+SyntheticInput::SyntheticInput(size_t num_presses, uint64_t press_interval_ns, uint64_t hold_ns)
+    : num_presses(num_presses), press_interval_ns(press_interval_ns),
+      hold_ns(std::min(hold_ns, press_interval_ns)) {
+}
+
+size_t SyntheticInput::get_event_count() const noexcept {
+    return num_presses * 2 + 1;
+}
+
+SDL_Event SyntheticInput::get_event(size_t index, uint64_t start_ns) const {
+    assert(index < get_event_count());
+
+    SDL_Event event{};
+    auto const press = index / 2;
+    if (press == num_presses) {
+        // a whole interval after the last release so its frames are drawn before quitting
+        event.type = SDL_EVENT_QUIT;
+        event.quit.timestamp = start_ns + num_presses * press_interval_ns;
+        return event;
+    }
+
+    bool const down = index % 2 == 0;
+    auto const scan_code = pressed_scan_codes[press % pressed_scan_codes.size()];
+
+    event.type = down ? SDL_EVENT_KEY_DOWN : SDL_EVENT_KEY_UP;
+    event.key.timestamp = start_ns + press * press_interval_ns + (down ? 0 : hold_ns);
+    event.key.scancode = scan_code;
+    event.key.key = SDL_GetKeyFromScancode(scan_code, SDL_KMOD_NONE, false);
+    event.key.mod = SDL_KMOD_NONE;
+    event.key.down = down;
+    event.key.repeat = false;
+    return event;
+}
+
+void SyntheticInput::start() {
+    thread = std::jthread{[this](std::stop_token stop_token) { run(std::move(stop_token), SDL_GetTicksNS()); }};
+}
+
+void SyntheticInput::run(std::stop_token stop_token, uint64_t start_ns) const {
+    for (size_t i = 0; i < get_event_count(); ++i) {
+        auto event = get_event(i, start_ns);
+        while (!stop_token.stop_requested()) {
+            auto const now_ns = SDL_GetTicksNS();
+            if (now_ns >= event.common.timestamp) {
+                break;
+            }
+
+            SDL_DelayNS(std::min(event.common.timestamp - now_ns, max_injector_sleep_ns));
+        }
+
+        if (stop_token.stop_requested()) {
+            return;
+        }
+
+        // stamped with when it was actually pushed, sleeping overshoots
+        event.common.timestamp = SDL_GetTicksNS();
+        SDL_PushEvent(&event);
+    }
+}
@@ -70,6 +70,27 @@ void TickResult::set_tessellation_settings_modified(bool tessellation_settings_m
     state.set(tessellation_settings_modified_bit, tessellation_settings_modified);
 }
 
+bool TickResult::plotted_function_cycled() const noexcept {
+    return state.test(cycle_plotted_function_bit);
+}
+
+void TickResult::set_plotted_function_cycled(bool plotted_function_cycled) noexcept {
+    state.set(cycle_plotted_function_bit, plotted_function_cycled);
+}
+
+bool TickResult::redraw_requested() const noexcept {
+    return state.test(redraw_requested_bit);
+}
+
+void TickResult::set_redraw_requested(bool redraw_requested) noexcept {
+    state.set(redraw_requested_bit, redraw_requested);
+}
+
+bool TickResult::needs_redraw() const noexcept {
+    return any_uniforms_modified() || wireframe_display_mode_changed() || plotted_function_cycled() ||
+           redraw_requested();
+}
+
 void TickResult::set_wireframe_display_mode_toggled(bool show_wireframe_only) noexcept {
     state.set(toggle_wireframe_display_bit, show_wireframe_only);
 }
@@ -0,0 +1,86 @@
+#include "action_bindings.hpp"
+#include "active_keys.hpp"
+#include "exceptions.hpp"
+
+#include <SDL3/SDL.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static ActionBindings parse(std::string const &config) {
+    std::istringstream in{config};
+    return ActionBindings::parse(in);
+}
+
+TEST(ActionBindingsTest, DefaultsMatchTheReadme) {
+    auto const bindings = ActionBindings::defaults();
+    EXPECT_EQ(Action::pan_x_positive, bindings.lookup(SDL_SCANCODE_RIGHT, false));
+    EXPECT_EQ(Action::pan_y_positive, bindings.lookup(SDL_SCANCODE_RIGHT, true));
+    EXPECT_EQ(Action::slow_orbit_up, bindings.lookup(SDL_SCANCODE_W, true));
+    EXPECT_EQ(Action::tessellation_up, bindings.lookup(SDL_SCANCODE_EQUALS, true));
+    EXPECT_FALSE(bindings.lookup(SDL_SCANCODE_EQUALS, false).has_value());
+    EXPECT_FALSE(bindings.lookup(SDL_SCANCODE_Q, false).has_value());
+}
+
+TEST(ActionBindingsTest, ShiftDoesTheSameUnlessBoundElsewhere) {
+    auto const bindings = ActionBindings::defaults();
+    EXPECT_EQ(Action::z_mult_up, bindings.lookup(SDL_SCANCODE_UP, true));
+    EXPECT_EQ(Action::toggle_wireframe, bindings.lookup(SDL_SCANCODE_E, true));
+}
+
+TEST(ActionBindingsTest, Parses) {
+    auto const bindings = ::parse("# orbit with the arrows\n"
+                                  "\n"
+                                  "orbit_up = Up\n"
+                                  "  slow_orbit_up=SHIFT+up  \n"
+                                  "next_function = t\n");
+
+    EXPECT_EQ(Action::orbit_up, bindings.lookup(SDL_SCANCODE_UP, false));
+    EXPECT_EQ(Action::slow_orbit_up, bindings.lookup(SDL_SCANCODE_UP, true));
+    EXPECT_EQ(Action::next_function, bindings.lookup(SDL_SCANCODE_T, false));
+    EXPECT_FALSE(bindings.lookup(SDL_SCANCODE_W, false).has_value());
+    EXPECT_EQ((std::vector{SDL_SCANCODE_UP, SDL_SCANCODE_T}),
+              std::vector(bindings.get_scan_codes().begin(), bindings.get_scan_codes().end()));
+}
+
+TEST(ActionBindingsTest, RejectsMalformedLines) {
+    EXPECT_THROW(::parse("orbit_up W\n"), InputError);
+    EXPECT_THROW(::parse("orbit_sideways = W\n"), InputError);
+    EXPECT_THROW(::parse("orbit_up = not a key\n"), InputError);
+
+    try {
+        (void)::parse("orbit_up = W\n\nspin = D\n");
+        FAIL() << "expected an InputError";
+    }
+    catch (InputError const &e) {
+        EXPECT_NE(std::string::npos, std::string{e.what()}.find("line 3"));
+    }
+}
+
+TEST(ActionBindingsTest, RejectsAKeyBoundTwice) {
+    EXPECT_THROW(::parse("orbit_up = W\nz_mult_up = W\n"), InputError);
+    EXPECT_NO_THROW(::parse("orbit_up = W\nslow_orbit_up = shift+W\n"));
+}
+
+TEST(ActionBindingsTest, HeldTimeAddsUpPerAction) {
+    const std::array keys = {
+        Binding{Action::orbit_up, SDL_SCANCODE_W, false},
+        Binding{Action::slow_orbit_up, SDL_SCANCODE_W, true},
+        Binding{Action::z_mult_up, SDL_SCANCODE_UP, false},
+        Binding{Action::z_mult_up, SDL_SCANCODE_T, false},
+    };
+    const ActionBindings bindings{keys};
+
+    // in the order of get_scan_codes
+    const std::array held = {HeldDuration{10, 5}, HeldDuration{3, 4}, HeldDuration{7, 0}};
+    auto const durations = bindings.held_ns(held);
+
+    EXPECT_EQ(10, durations[static_cast<std::size_t>(Action::orbit_up)]);
+    EXPECT_EQ(5, durations[static_cast<std::size_t>(Action::slow_orbit_up)]);
+    EXPECT_EQ(14, durations[static_cast<std::size_t>(Action::z_mult_up)]);
+    EXPECT_EQ(0, durations[static_cast<std::size_t>(Action::orbit_down)]);
+}
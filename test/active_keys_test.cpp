@@ -5,7 +5,10 @@
 #include <SDL3/SDL.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <list>
 #include <optional>
@@ -619,3 +622,114 @@ TEST_F(ActiveKeysTest, WhichKeyVariantWasPressedSince) {
     query_result = active.which_key_variant_was_pressed_since(after_release_key_ms, SDL_GetTicks(), any_key);
     EXPECT_EQ(nullopt, query_result);
 }
+
+TEST_F(ActiveKeysTest, WhichKeyVariantsWerePressedSinceMatchesSingleQueries) {
+    const Key any_key{any_scancode};
+    const Key any_shifted_key{any_scancode, KeyMod::shift()};
+    ActiveKeys active{any_key, any_shifted_key, Key{SDL_SCANCODE_UP}};
+
+    std::array const scan_codes{any_scancode, any_other_scancode, SDL_SCANCODE_UP};
+    std::array<std::optional<KeyAtTime>, scan_codes.size()> results;
+
+    auto const expect_same_as_single_queries = [&](uint64_t start_ms, uint64_t end_ms) {
+        active.which_key_variants_were_pressed_since(start_ms, end_ms, scan_codes, results);
+        for (size_t i = 0; i < scan_codes.size(); ++i) {
+            EXPECT_EQ(active.which_key_variant_was_pressed_since(start_ms, end_ms, scan_codes[i]), results[i]);
+        }
+    };
+
+    auto const start_ms = SDL_GetTicks();
+    expect_same_as_single_queries(start_ms, SDL_GetTicks());
+    EXPECT_EQ(nullopt, results[0]);
+
+    active.press_key(any_key);
+    active.press_key(Key{SDL_SCANCODE_UP});
+    SDL_Delay(1);
+    expect_same_as_single_queries(start_ms, SDL_GetTicks());
+    EXPECT_NE(nullopt, results[0]);
+    EXPECT_EQ(nullopt, results[1]);
+    EXPECT_NE(nullopt, results[2]);
+
+    active.press_key(any_shift_key);
+    active.press_key(any_shifted_key);
+    SDL_Delay(1);
+    expect_same_as_single_queries(start_ms, SDL_GetTicks());
+    EXPECT_TRUE(std::get<0>(*results[0]).has_shift());
+
+    active.release_key(any_shifted_key);
+    active.release_key(Key{SDL_SCANCODE_UP});
+    SDL_Delay(1);
+    auto const after_release_ms = SDL_GetTicks();
+    expect_same_as_single_queries(after_release_ms, SDL_GetTicks());
+    EXPECT_EQ(nullopt, results[0]);
+    EXPECT_EQ(nullopt, results[2]);
+}
+
+TEST_F(ActiveKeysTest, HeldDurationCountsEveryPress) {
+    const Key any_key{any_scancode};
+    const Key any_shifted_key{any_scancode, KeyMod::shift()};
+    ActiveKeys active{any_key};
+
+    EXPECT_EQ(0, active.held_duration(0, 100, any_scancode).total_ns());
+    EXPECT_EQ(0, active.held_duration(0, 100, any_other_scancode).total_ns());
+
+    // tapped twice within one frame, the first tap must not be lost
+    active.press_key(any_key, 10);
+    active.release_key(any_key, 15);
+    active.press_key(any_key, 20);
+    active.release_key(any_key, 25);
+
+    auto const tapped = active.held_duration(0, 100, any_scancode);
+    EXPECT_EQ(10, tapped.unshifted_ns);
+    EXPECT_EQ(0, tapped.shifted_ns);
+
+    active.press_key(any_shift_key, 30);
+    active.press_key(any_shifted_key, 30);
+
+    // still held, counts up to the end of the window
+    auto const shifted = active.held_duration(26, 100, any_scancode);
+    EXPECT_EQ(0, shifted.unshifted_ns);
+    EXPECT_EQ(70, shifted.shifted_ns);
+
+    std::array const scan_codes{any_scancode, any_other_scancode};
+    std::array<HeldDuration, scan_codes.size()> results;
+    active.held_durations(0, 100, scan_codes, results);
+    EXPECT_EQ(10, results[0].unshifted_ns);
+    EXPECT_EQ(70, results[0].shifted_ns);
+    EXPECT_EQ(0, results[1].total_ns());
+}
+
+TEST_F(ActiveKeysTest, HeldDurationUsesEventTimestamps) {
+    const Key any_key{any_scancode};
+    ActiveKeys active{any_key};
+
+    // a synthetic stream of events that happened well before they are processed, evenly spaced
+    auto const stream_start_ns = SDL_GetTicksNS();
+    constexpr uint64_t press_ns = 3'000'000;
+    constexpr uint64_t gap_ns = 2'000'000;
+    constexpr size_t num_presses = 4;
+
+    for (size_t i = 0; i < num_presses; ++i) {
+        auto const pressed_at_ns = stream_start_ns + i * (press_ns + gap_ns);
+        active.press_key(any_key, pressed_at_ns);
+
+        // processing jitter must not show up in the held time
+        SDL_Delay(i % 2);
+        active.release_key(any_key, pressed_at_ns + press_ns);
+    }
+
+    auto const stream_end_ns = stream_start_ns + num_presses * (press_ns + gap_ns);
+    EXPECT_EQ(num_presses * press_ns, active.held_duration(stream_start_ns, stream_end_ns, any_scancode).total_ns());
+
+    // back to back windows add up to the same total however the stream is cut into frames
+    uint64_t windowed_ns = 0;
+    for (auto window_start_ns = stream_start_ns; window_start_ns < stream_end_ns; window_start_ns += 1'700'000) {
+        auto const window_end_ns = std::min(window_start_ns + 1'700'000, stream_end_ns);
+        windowed_ns += active.held_duration(window_start_ns, window_end_ns, any_scancode).total_ns();
+    }
+    EXPECT_EQ(num_presses * press_ns, windowed_ns);
+
+    // the millisecond queries see the same times as SDL_GetTicks
+    auto const last_pressed_at_ns = stream_start_ns + (num_presses - 1) * (press_ns + gap_ns);
+    EXPECT_EQ(last_pressed_at_ns / 1'000'000, active.get(any_key).value()->first);
+}
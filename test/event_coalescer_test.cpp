@@ -0,0 +1,106 @@
+#include "event_coalescer.hpp"
+
+#include <SDL3/SDL.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+using std::size_t;
+using std::vector;
+
+class EventCoalescerTest : public testing::Test {
+protected:
+    static SDL_Event wheel(Sint32 integer_y) {
+        SDL_Event event{};
+        event.type = SDL_EVENT_MOUSE_WHEEL;
+        event.wheel.integer_y = integer_y;
+        event.wheel.y = static_cast<float>(integer_y);
+        return event;
+    }
+
+    static SDL_Event motion(float xrel, float yrel, SDL_MouseButtonFlags state = 0) {
+        SDL_Event event{};
+        event.type = SDL_EVENT_MOUSE_MOTION;
+        event.motion.xrel = xrel;
+        event.motion.yrel = yrel;
+        event.motion.state = state;
+        return event;
+    }
+
+    static SDL_Event key(SDL_EventType type, SDL_Scancode scan_code, bool repeat = false) {
+        SDL_Event event{};
+        event.type = type;
+        event.key.scancode = scan_code;
+        event.key.repeat = repeat;
+        return event;
+    }
+
+    static vector<Uint32> types(vector<SDL_Event> const &events, size_t count) {
+        vector<Uint32> result;
+        for (size_t i = 0; i < count; ++i) {
+            result.push_back(events[i].type);
+        }
+        return result;
+    }
+};
+
+TEST_F(EventCoalescerTest, EmptyStaysEmpty) {
+    vector<SDL_Event> events;
+    EXPECT_EQ(0, coalesce_events(events));
+}
+
+TEST_F(EventCoalescerTest, SumsWheelRuns) {
+    vector<SDL_Event> events{wheel(1), wheel(2), wheel(-1)};
+    ASSERT_EQ(1, coalesce_events(events));
+    EXPECT_EQ(2, events[0].wheel.integer_y);
+    EXPECT_FLOAT_EQ(2.0f, events[0].wheel.y);
+}
+
+TEST_F(EventCoalescerTest, SumsMotionWithTheSameButtons) {
+    vector<SDL_Event> events{motion(1, 2), motion(3, 4), motion(5, 6, SDL_BUTTON_LMASK)};
+    ASSERT_EQ(2, coalesce_events(events));
+    EXPECT_FLOAT_EQ(4.0f, events[0].motion.xrel);
+    EXPECT_FLOAT_EQ(6.0f, events[0].motion.yrel);
+    EXPECT_FLOAT_EQ(5.0f, events[1].motion.xrel);
+}
+
+TEST_F(EventCoalescerTest, DropsRepeatsAfterTheFirst) {
+    vector<SDL_Event> events{
+        key(SDL_EVENT_KEY_DOWN, SDL_SCANCODE_W),       key(SDL_EVENT_KEY_DOWN, SDL_SCANCODE_A),
+        key(SDL_EVENT_KEY_DOWN, SDL_SCANCODE_W, true), key(SDL_EVENT_KEY_DOWN, SDL_SCANCODE_A, true),
+        key(SDL_EVENT_KEY_DOWN, SDL_SCANCODE_W, true), key(SDL_EVENT_KEY_DOWN, SDL_SCANCODE_A, true),
+    };
+    ASSERT_EQ(4, coalesce_events(events));
+    EXPECT_EQ(SDL_SCANCODE_W, events[2].key.scancode);
+    EXPECT_EQ(SDL_SCANCODE_A, events[3].key.scancode);
+}
+
+TEST_F(EventCoalescerTest, NeverDropsKeyTransitions) {
+    vector<SDL_Event> events;
+    for (int i = 0; i < 10; ++i) {
+        events.push_back(key(SDL_EVENT_KEY_DOWN, SDL_SCANCODE_W));
+        events.push_back(key(SDL_EVENT_KEY_UP, SDL_SCANCODE_W));
+    }
+
+    auto const original = events;
+    ASSERT_EQ(original.size(), coalesce_events(events));
+    EXPECT_EQ(types(original, original.size()), types(events, events.size()));
+}
+
+TEST_F(EventCoalescerTest, TransitionsEndRuns) {
+    vector<SDL_Event> events{wheel(1), wheel(1), key(SDL_EVENT_KEY_UP, SDL_SCANCODE_W), wheel(1), wheel(1)};
+    auto const kept = coalesce_events(events);
+    ASSERT_EQ(3, kept);
+    EXPECT_EQ((vector<Uint32>{SDL_EVENT_MOUSE_WHEEL, SDL_EVENT_KEY_UP, SDL_EVENT_MOUSE_WHEEL}), types(events, kept));
+    EXPECT_EQ(2, events[0].wheel.integer_y);
+    EXPECT_EQ(2, events[2].wheel.integer_y);
+}
+
+TEST_F(EventCoalescerTest, MergesAcrossInterleavedRuns) {
+    vector<SDL_Event> events{motion(1, 1), wheel(1), key(SDL_EVENT_KEY_DOWN, SDL_SCANCODE_W, true),
+                             motion(1, 1), wheel(1), key(SDL_EVENT_KEY_DOWN, SDL_SCANCODE_W, true)};
+    ASSERT_EQ(3, coalesce_events(events));
+    EXPECT_FLOAT_EQ(2.0f, events[0].motion.xrel);
+    EXPECT_EQ(2, events[1].wheel.integer_y);
+}
@@ -0,0 +1,141 @@
+#include "exceptions.hpp"
+#include "expression.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using std::size_t;
+using std::string;
+using std::vector;
+
+/** the function that used to be hard coded into the shaders */
+constexpr const auto default_function = "sin(10*(x^2+y^2))";
+
+TEST(Expression, ParsesPrecedence) {
+    auto const ast = parse_expression("1 + 2 * x ^ 2");
+    EXPECT_EQ("(1 + (2 * pow(x, 2)))", expression_to_string(ast));
+
+    // unary minus binds looser than ^
+    EXPECT_EQ("(-pow(x, 2))", expression_to_string(parse_expression("-x^2")));
+
+    // ^ is right associative
+    EXPECT_EQ("pow(x, pow(y, 2))", expression_to_string(parse_expression("x^y^2")));
+
+    // left associative
+    EXPECT_EQ("((x - y) - 1)", expression_to_string(parse_expression("x - y - 1")));
+}
+
+TEST(Expression, ParsesFunctionsAndConstants) {
+    EXPECT_EQ("sin(x)", expression_to_string(parse_expression("sin( x )")));
+    EXPECT_EQ("pow(x, y)", expression_to_string(parse_expression("pow(x, y)")));
+    EXPECT_NO_THROW(parse_expression("pi * e"));
+    EXPECT_NO_THROW(parse_expression("1.5e-3 * x"));
+}
+
+TEST(Expression, RejectsMalformed) {
+    EXPECT_THROW(parse_expression(""), ExpressionError);
+    EXPECT_THROW(parse_expression("x +"), ExpressionError);
+    EXPECT_THROW(parse_expression("(x"), ExpressionError);
+    EXPECT_THROW(parse_expression("z"), ExpressionError);
+    EXPECT_THROW(parse_expression("sin(x, y)"), ExpressionError);
+    EXPECT_THROW(parse_expression("x y"), ExpressionError);
+    EXPECT_THROW(parse_expression("1..2"), ExpressionError);
+}
+
+TEST(Expression, ConstantFolding) {
+    auto const folded = optimize_expression(parse_expression("2 * 3 + x"));
+    EXPECT_EQ("(6 + x)", expression_to_string(folded));
+
+    auto const identity = optimize_expression(parse_expression("(x + 0) * 1 - 0"));
+    EXPECT_EQ("x", expression_to_string(identity));
+
+    EXPECT_EQ("x", expression_to_string(optimize_expression(parse_expression("--x"))));
+    EXPECT_THROW(optimize_expression(parse_expression("1 / 0")), ExpressionError);
+}
+
+TEST(Expression, StrengthReduction) {
+    auto const squared = optimize_expression(parse_expression("pow(x, 2.0)"));
+    EXPECT_EQ(ExpressionOp::square, squared.op);
+    EXPECT_EQ("(x * x)", expression_to_glsl(squared));
+
+    // non trivial bases use the helper so they are only evaluated once
+    auto const squared_sum = optimize_expression(parse_expression("(x + y)^2"));
+    EXPECT_EQ("expression_square((x + y))", expression_to_glsl(squared_sum));
+
+    EXPECT_EQ(ExpressionOp::sqrt, optimize_expression(parse_expression("x^0.5")).op);
+    EXPECT_EQ("x", expression_to_string(optimize_expression(parse_expression("x^1"))));
+}
+
+TEST(Expression, GlslLiterals) {
+    // glsl float literals need a decimal point
+    EXPECT_EQ("(10.0 * x)", expression_to_glsl(parse_expression("10 * x")));
+    EXPECT_EQ("((-2.5) * x)", expression_to_glsl(optimize_expression(parse_expression("-2.5 * x"))));
+
+    // finite as a double but not as a float
+    EXPECT_THROW(CompiledExpression{"1e300 * x"}, InputError);
+    EXPECT_THROW(CompiledExpression{"x - 1e20 * 1e20"}, InputError);
+    EXPECT_NO_THROW(CompiledExpression{"3e38 * x"});
+}
+
+TEST(Expression, CpuMatchesReference) {
+    const CompiledExpression compiled{default_function};
+
+    vector<float> xs;
+    vector<float> ys;
+    // more than one block
+    for (size_t i = 0; i < 1000; ++i) {
+        xs.push_back(static_cast<float>(i) / 500.0f - 1.0f);
+        ys.push_back(1.0f - static_cast<float>(i) / 700.0f);
+    }
+
+    vector<float> out(xs.size());
+    compiled.get_cpu().evaluate(xs, ys, out);
+
+    for (size_t i = 0; i < xs.size(); ++i) {
+        auto const expected = std::sin(10.0f * (xs[i] * xs[i] + ys[i] * ys[i]));
+        EXPECT_NEAR(expected, out[i], 1e-5f);
+    }
+
+    EXPECT_NEAR(std::sin(10.0f * 0.5f), compiled.get_cpu().evaluate(0.5f, 0.5f), 1e-5f);
+}
+
+TEST(Expression, CpuEveryOp) {
+    const CompiledExpression compiled{"-sqrt(abs(x)) + exp(y) / cos(y) - log(2 + x) * pow(abs(tan(x)), 1.5) + y^2"};
+
+    vector<float> xs;
+    vector<float> ys;
+    for (size_t i = 0; i < 300; ++i) {
+        xs.push_back(static_cast<float>(i) / 300.0f - 0.5f);
+        ys.push_back(0.5f - static_cast<float>(i) / 400.0f);
+    }
+
+    vector<float> out(xs.size());
+    compiled.get_cpu().evaluate(xs, ys, out);
+
+    for (size_t i = 0; i < xs.size(); ++i) {
+        auto const x = xs[i];
+        auto const y = ys[i];
+        auto const expected = -std::sqrt(std::abs(x)) + std::exp(y) / std::cos(y) -
+                              std::log(2.0f + x) * std::pow(std::abs(std::tan(x)), 1.5f) + y * y;
+        EXPECT_NEAR(expected, out[i], 1e-5f);
+    }
+}
+
+TEST(Expression, EquivalentExpressionsShareHash) {
+    const CompiledExpression a{"sin(10*(x^2+y^2))"};
+    const CompiledExpression b{"sin(10 * (pow(x, 2.0) + (y^1)^2.0))"};
+    const CompiledExpression c{"cos(x)"};
+
+    EXPECT_EQ(a.get_hash(), b.get_hash());
+    EXPECT_NE(a.get_hash(), c.get_hash());
+}
+
+TEST(Expression, GlslFunction) {
+    const CompiledExpression compiled{default_function};
+    EXPECT_NE(string::npos, compiled.get_glsl().find("float plotted_function(float x, float y)"));
+    EXPECT_EQ(string::npos, compiled.get_glsl().find("pow("));
+}
@@ -0,0 +1,59 @@
+#include "frame_time_stats.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using std::vector;
+
+TEST(FrameTimeStats, Empty) {
+    const FrameTimeStats stats;
+    EXPECT_EQ(0, stats.get_count());
+    EXPECT_EQ(0.0, stats.get_mean_ns());
+    EXPECT_EQ(0.0, stats.get_variance_ns2());
+    EXPECT_EQ(0, stats.get_min_ns());
+    EXPECT_EQ(0, stats.get_max_ns());
+}
+
+TEST(FrameTimeStats, SingleFrameHasNoVariance) {
+    FrameTimeStats stats;
+    stats.add(16'666'667);
+    EXPECT_EQ(1, stats.get_count());
+    EXPECT_DOUBLE_EQ(16'666'667.0, stats.get_mean_ns());
+    EXPECT_EQ(0.0, stats.get_variance_ns2());
+}
+
+TEST(FrameTimeStats, MatchesTwoPass) {
+    const vector<uint64_t> frame_times{16'000'000, 17'000'000, 16'500'000, 33'000'000, 16'700'000};
+
+    FrameTimeStats stats;
+    double sum = 0.0;
+    for (auto const frame_time : frame_times) {
+        stats.add(frame_time);
+        sum += static_cast<double>(frame_time);
+    }
+
+    auto const mean = sum / static_cast<double>(frame_times.size());
+    double squares = 0.0;
+    for (auto const frame_time : frame_times) {
+        squares += std::pow(static_cast<double>(frame_time) - mean, 2.0);
+    }
+    auto const variance = squares / static_cast<double>(frame_times.size() - 1);
+
+    EXPECT_DOUBLE_EQ(mean, stats.get_mean_ns());
+    EXPECT_NEAR(variance, stats.get_variance_ns2(), variance * 1e-9);
+    EXPECT_NEAR(std::sqrt(variance), stats.get_stddev_ns(), 1e-3);
+    EXPECT_EQ(16'000'000, stats.get_min_ns());
+    EXPECT_EQ(33'000'000, stats.get_max_ns());
+}
+
+TEST(FrameTimeStats, Reset) {
+    FrameTimeStats stats;
+    stats.add(1);
+    stats.add(3);
+    stats.reset();
+    EXPECT_EQ(0, stats.get_count());
+    EXPECT_EQ(0, stats.get_max_ns());
+}
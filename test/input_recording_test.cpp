@@ -0,0 +1,180 @@
+#include "exceptions.hpp"
+#include "input_recording.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+using std::vector;
+
+class InputRecordingTest : public testing::Test {
+protected:
+    static SDL_Event key(SDL_EventType type, SDL_Scancode scan_code, uint64_t timestamp_ns, bool repeat = false) {
+        SDL_Event event{};
+        event.type = type;
+        event.key.timestamp = timestamp_ns;
+        event.key.scancode = scan_code;
+        event.key.key = 'w';
+        event.key.mod = SDL_KMOD_LSHIFT;
+        event.key.down = type == SDL_EVENT_KEY_DOWN;
+        event.key.repeat = repeat;
+        return event;
+    }
+
+    static SDL_Event wheel(Sint32 integer_y, uint64_t timestamp_ns) {
+        SDL_Event event{};
+        event.type = SDL_EVENT_MOUSE_WHEEL;
+        event.wheel.timestamp = timestamp_ns;
+        event.wheel.integer_y = integer_y;
+        event.wheel.y = static_cast<float>(integer_y);
+        event.wheel.mouse_x = 12.5f;
+        return event;
+    }
+
+    static SDL_Event quit(uint64_t timestamp_ns) {
+        SDL_Event event{};
+        event.type = SDL_EVENT_QUIT;
+        event.quit.timestamp = timestamp_ns;
+        return event;
+    }
+
+    /** a tick with a key press and a wheel run, a skipped one, then one that quit */
+    static InputRecording make_recording() {
+        InputRecording recording{1'500'000};
+
+        recording.begin_tick(2'000'000);
+        vector<SDL_Event> const batch{key(SDL_EVENT_KEY_DOWN, SDL_SCANCODE_W, 2'100'000),
+                                      wheel(1, 2'200'000), wheel(2, 2'300'000)};
+        recording.add_batch(batch);
+        recording.end_tick(18'000'000);
+
+        recording.begin_tick(18'500'000);
+        recording.end_tick(std::nullopt);
+
+        recording.begin_tick(34'000'000);
+        vector<SDL_Event> const last{key(SDL_EVENT_KEY_UP, SDL_SCANCODE_W, 34'100'000), quit(34'200'000)};
+        recording.add_batch(last);
+        recording.end_tick(std::nullopt);
+
+        return recording;
+    }
+};
+
+TEST_F(InputRecordingTest, RoundTrips) {
+    auto const recording = make_recording();
+    std::stringstream stream;
+    recording.write(stream);
+
+    auto const read = InputRecording::read(stream);
+    EXPECT_EQ(recording.get_started_at_ns(), read.get_started_at_ns());
+    ASSERT_EQ(3, read.get_ticks().size());
+
+    auto const &first = read.get_ticks()[0];
+    EXPECT_EQ(2'000'000, first.start_ns);
+    EXPECT_EQ(18'000'000, first.integrated_until_ns);
+    ASSERT_EQ(1, first.batches.size());
+    ASSERT_EQ(3, first.batches[0].size());
+
+    auto const &pressed = first.batches[0][0].key;
+    EXPECT_EQ(static_cast<Uint32>(SDL_EVENT_KEY_DOWN), first.batches[0][0].type);
+    EXPECT_EQ(2'100'000, pressed.timestamp);
+    EXPECT_EQ(SDL_SCANCODE_W, pressed.scancode);
+    EXPECT_EQ('w', pressed.key);
+    EXPECT_EQ(SDL_KMOD_LSHIFT, pressed.mod);
+    EXPECT_TRUE(pressed.down);
+    EXPECT_FALSE(pressed.repeat);
+
+    auto const &scrolled = first.batches[0][2].wheel;
+    EXPECT_EQ(2, scrolled.integer_y);
+    EXPECT_FLOAT_EQ(2.0f, scrolled.y);
+    EXPECT_FLOAT_EQ(12.5f, scrolled.mouse_x);
+
+    EXPECT_FALSE(read.get_ticks()[1].integrated_until_ns.has_value());
+    EXPECT_TRUE(read.get_ticks()[1].batches.empty());
+
+    auto const &last = read.get_ticks()[2].batches[0];
+    ASSERT_EQ(2, last.size());
+    EXPECT_EQ(static_cast<Uint32>(SDL_EVENT_QUIT), last[1].type);
+    EXPECT_EQ(34'200'000, last[1].common.timestamp);
+}
+
+TEST_F(InputRecordingTest, RejectsOtherFiles) {
+    std::stringstream stream{std::string{"not a recording"}};
+    EXPECT_THROW(static_cast<void>(InputRecording::read(stream)), InputError);
+}
+
+TEST_F(InputRecordingTest, RejectsCutShortRecordings) {
+    std::stringstream written;
+    make_recording().write(written);
+    auto const bytes = written.str();
+
+    std::stringstream cut{bytes.substr(0, bytes.size() - 3)};
+    EXPECT_THROW(static_cast<void>(InputRecording::read(cut)), InputError);
+}
+
+TEST_F(InputRecordingTest, RejectsCountsTheFileCantHold) {
+    // a recording of one tick, up to where it says how many batches it has
+    auto const header = [](uint32_t num_batches) {
+        std::string bytes{"3dgi"};
+        auto const append = [&](auto value) { bytes.append(reinterpret_cast<char const *>(&value), sizeof(value)); };
+        append(uint32_t{1});
+        append(uint64_t{1'000'000});
+        append(uint64_t{1});
+        append(uint64_t{1'500'000});
+        append(uint64_t{2'000'000});
+        append(num_batches);
+        return bytes;
+    };
+
+    std::stringstream too_many_batches{header(UINT32_MAX) + std::string(64, '\0')};
+    EXPECT_THROW(static_cast<void>(InputRecording::read(too_many_batches)), InputError);
+
+    auto too_many_events = header(1);
+    auto const num_events = UINT32_MAX;
+    too_many_events.append(reinterpret_cast<char const *>(&num_events), sizeof(num_events));
+    std::stringstream too_many_events_stream{too_many_events};
+    EXPECT_THROW(static_cast<void>(InputRecording::read(too_many_events_stream)), InputError);
+}
+
+TEST_F(InputRecordingTest, ReplaysOnAVirtualClockShiftedByWholeMilliseconds) {
+    auto const recording = make_recording();
+    InputReplay replay{recording, 7'654'321};
+
+    // 1.5 ms recorded start moved to 7.5 ms, keeping the sub-ms part
+    EXPECT_EQ(7'500'000, replay.get_started_at_ns());
+    EXPECT_EQ(replay.get_started_at_ns(), replay.get_now_ns());
+    EXPECT_FALSE(replay.is_finished());
+    EXPECT_EQ(24'000'000, replay.get_next_due_ns());
+
+    auto const first = replay.next();
+    EXPECT_EQ(8'000'000, first.start_ns);
+    EXPECT_EQ(8'000'000, replay.get_now_ns());
+    EXPECT_EQ(24'000'000, first.integrated_until_ns);
+    EXPECT_EQ(8'100'000, first.batches[0][0].key.timestamp);
+    EXPECT_EQ(8'300'000, first.batches[0][2].wheel.timestamp);
+
+    // skipped ticks are due when they started
+    EXPECT_EQ(24'500'000, replay.get_next_due_ns());
+    EXPECT_FALSE(replay.next().integrated_until_ns.has_value());
+
+    auto const last = replay.next();
+    EXPECT_EQ(40'200'000, last.batches[0][1].common.timestamp);
+    EXPECT_TRUE(replay.is_finished());
+}
+
+TEST_F(InputRecordingTest, ReplaysEarlierThanRecorded) {
+    auto const recording = make_recording();
+    InputReplay replay{recording, 200'000};
+
+    // moved back by a whole ms
+    EXPECT_EQ(500'000, replay.get_started_at_ns());
+    auto const first = replay.next();
+    EXPECT_EQ(1'000'000, first.start_ns);
+    EXPECT_EQ(1'100'000, first.batches[0][0].key.timestamp);
+}
@@ -0,0 +1,51 @@
+#include "key_table.hpp"
+
+#include <SDL3/SDL.h>
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <utility>
+
+static_assert(us_key_from_scan_code(SDL_SCANCODE_EQUALS, true) == SDLK_PLUS);
+static_assert(us_scan_code_from_key(SDLK_PLUS) == std::pair{SDL_SCANCODE_EQUALS, SDL_Keymod{SDL_KMOD_SHIFT}});
+
+TEST(KeyTableTest, LettersDigitsAndSymbols) {
+    EXPECT_EQ(SDLK_A, us_key_from_scan_code(SDL_SCANCODE_A, false));
+    EXPECT_EQ(SDLK_Z, us_key_from_scan_code(SDL_SCANCODE_Z, false));
+    EXPECT_EQ(SDLK_0, us_key_from_scan_code(SDL_SCANCODE_0, false));
+    EXPECT_EQ(SDLK_DOLLAR, us_key_from_scan_code(SDL_SCANCODE_4, true));
+    EXPECT_EQ(SDLK_MINUS, us_key_from_scan_code(SDL_SCANCODE_MINUS, false));
+    EXPECT_EQ(SDLK_ESCAPE, us_key_from_scan_code(SDL_SCANCODE_ESCAPE, true));
+}
+
+TEST(KeyTableTest, KeysThatTypeNothing) {
+    EXPECT_FALSE(us_key_from_scan_code(SDL_SCANCODE_UNKNOWN, false).has_value());
+    EXPECT_FALSE(us_key_from_scan_code(SDL_SCANCODE_UP, false).has_value());
+    EXPECT_FALSE(us_key_from_scan_code(SDL_SCANCODE_LSHIFT, true).has_value());
+    EXPECT_FALSE(us_key_from_scan_code(SDL_SCANCODE_NONUSHASH, false).has_value());
+    EXPECT_FALSE(us_scan_code_from_key(SDLK_UNKNOWN).has_value());
+    EXPECT_FALSE(us_scan_code_from_key(SDLK_LSHIFT).has_value());
+}
+
+TEST(KeyTableTest, RoundTrips) {
+    for (auto scan_code = SDL_SCANCODE_A; scan_code <= SDL_SCANCODE_SLASH;
+         scan_code = static_cast<SDL_Scancode>(scan_code + 1)) {
+        auto const key_code = us_key_from_scan_code(scan_code, false);
+        if (!key_code.has_value()) {
+            continue;
+        }
+
+        auto const found = us_scan_code_from_key(*key_code);
+        ASSERT_TRUE(found.has_value()) << "scan code " << scan_code;
+        EXPECT_EQ(scan_code, found->first);
+        EXPECT_EQ(SDL_KMOD_NONE, found->second);
+    }
+}
+
+TEST(KeyTableTest, UnshiftedWins) {
+    // return types the same either way
+    auto const found = us_scan_code_from_key(SDLK_RETURN);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(SDL_SCANCODE_RETURN, found->first);
+    EXPECT_EQ(SDL_KMOD_NONE, found->second);
+}
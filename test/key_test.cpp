@@ -58,6 +58,27 @@ TEST_F(KeyTest, CtorFromVariant) {
     EXPECT_EQ(Key(plus_scan_code_variant), plus_scan_code);
 }
 
+TEST_F(KeyTest, ResolvedAtCompileTime) {
+    // the US layout stands in for the live one
+    static constexpr Key plus{SDLK_PLUS};
+    static_assert(plus == Key{SDL_SCANCODE_EQUALS, SDL_KMOD_SHIFT});
+    static_assert(Key{SDL_SCANCODE_EQUALS, SDL_KMOD_LSHIFT}.get_key_code() == SDLK_PLUS);
+    static_assert(!Key{SDL_SCANCODE_LSHIFT}.has_key_code());
+
+    static_assert(KeyEquivalentEqualTo<>{}(Key{SDL_SCANCODE_RSHIFT}, Key{SDL_SCANCODE_LSHIFT, SDL_KMOD_SHIFT}));
+    static_assert(KeyEquivalentHash<>{}(Key{any_scancode, SDL_KMOD_LSHIFT}) ==
+                  KeyEquivalentHash<>{}(Key{any_scancode, SDL_KMOD_RSHIFT}));
+    static_assert(std::hash<Key>{}(plus) != std::hash<Key>{}(plus.without_shift()));
+
+    EXPECT_EQ(SDL_SCANCODE_EQUALS, plus.get_scan_code());
+}
+
+TEST_F(KeyTest, KeyCodeFromTheEventIsKept) {
+    // e.g. another layout, the key code is not looked up again
+    const Key from_event{SDL_SCANCODE_Q, SDLK_A, SDL_KMOD_NONE};
+    EXPECT_EQ(SDLK_A, from_event.get_key_code());
+}
+
 TEST_F(KeyTest, Format) {
     const Key any_key{any_scancode};
     auto const formatted = std::format("{}", any_key);
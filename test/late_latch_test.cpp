@@ -0,0 +1,65 @@
+#include "late_latch.hpp"
+#include "render_snapshot.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+namespace {
+void expect_near(glm::mat4 const &expected, glm::mat4 const &actual) {
+    for (int column = 0; column < 4; ++column) {
+        for (int row = 0; row < 4; ++row) {
+            EXPECT_NEAR(expected[column][row], actual[column][row], 1e-5f) << "column " << column << " row " << row;
+        }
+    }
+}
+} // namespace
+
+static constexpr uint64_t max_ahead_ns = 32'000'000;
+
+TEST(LateLatchTest, StillSnapshotIsDrawnAsIs) {
+    const LateLatch latch{max_ahead_ns};
+    RenderSnapshot snapshot;
+    snapshot.model = glm::rotate(glm::mat4{1.0f}, 0.5f, glm::vec3{0.0f, 1.0f, 0.0f});
+    snapshot.sampled_at_ns = 1'000;
+
+    EXPECT_FALSE(LateLatch::is_moving(snapshot));
+    EXPECT_EQ(snapshot.model, latch.model_at(snapshot, 5'000'000));
+}
+
+TEST(LateLatchTest, RotatesOnToNow) {
+    const LateLatch latch{max_ahead_ns};
+    RenderSnapshot snapshot;
+    snapshot.sampled_at_ns = 1'000'000;
+    snapshot.model_rotation_rads_per_ns = glm::vec2{1e-7f, 0.0f};
+    EXPECT_TRUE(LateLatch::is_moving(snapshot));
+
+    // nothing to extrapolate yet
+    ::expect_near(snapshot.model, latch.model_at(snapshot, snapshot.sampled_at_ns));
+
+    auto const rotated = glm::rotate(glm::mat4{1.0f}, 1e-7f * 4'000'000.0f, glm::vec3{1.0f, 0.0f, 0.0f});
+    ::expect_near(rotated, latch.model_at(snapshot, snapshot.sampled_at_ns + 4'000'000));
+}
+
+TEST(LateLatchTest, RotatesAboutXThenY) {
+    const LateLatch latch{max_ahead_ns};
+    RenderSnapshot snapshot;
+    snapshot.model_rotation_rads_per_ns = glm::vec2{1e-7f, -2e-7f};
+
+    auto const about_x = glm::rotate(glm::mat4{1.0f}, 0.1f, glm::vec3{1.0f, 0.0f, 0.0f});
+    auto const then_y = glm::rotate(glm::mat4{1.0f}, -0.2f, glm::vec3{0.0f, 1.0f, 0.0f}) * about_x;
+    ::expect_near(then_y, latch.model_at(snapshot, 1'000'000));
+}
+
+TEST(LateLatchTest, DoesNotRunAwayFromAStalledSnapshot) {
+    const LateLatch latch{max_ahead_ns};
+    RenderSnapshot snapshot;
+    snapshot.model_rotation_rads_per_ns = glm::vec2{0.0f, 1e-8f};
+
+    ::expect_near(latch.model_at(snapshot, max_ahead_ns), latch.model_at(snapshot, max_ahead_ns * 10));
+}
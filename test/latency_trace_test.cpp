@@ -0,0 +1,57 @@
+#include "latency_trace.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <format>
+#include <string>
+
+TEST(LatencyTraceTest, Empty) {
+    const LatencyTrace trace;
+    EXPECT_EQ(0, trace.get_count(LatencyStage::swapped));
+    EXPECT_EQ(0, trace.get_percentile_ns(LatencyStage::swapped, 50.0));
+}
+
+TEST(LatencyTraceTest, LatencyIsFromTheInputTimestamp) {
+    LatencyTrace trace;
+    trace.add(LatencyStage::processed, 1'000, 1'500);
+    trace.add(LatencyStage::swapped, 1'000, 9'000);
+
+    EXPECT_EQ(1, trace.get_count(LatencyStage::processed));
+    EXPECT_EQ(500, trace.get_percentile_ns(LatencyStage::processed, 50.0));
+    EXPECT_EQ(8'000, trace.get_percentile_ns(LatencyStage::swapped, 50.0));
+    EXPECT_EQ(0, trace.get_count(LatencyStage::published));
+}
+
+TEST(LatencyTraceTest, IgnoresStagesBeforeTheInput) {
+    LatencyTrace trace;
+    trace.add(LatencyStage::submitted, 2'000, 1'000);
+    EXPECT_EQ(0, trace.get_count(LatencyStage::submitted));
+}
+
+TEST(LatencyTraceTest, NearestRankPercentiles) {
+    LatencyTrace trace;
+
+    // added out of order, 1..100 us
+    for (uint64_t i = 100; i >= 1; --i) {
+        trace.add(LatencyStage::gpu_complete, 0, i * 1'000);
+    }
+
+    EXPECT_EQ(100, trace.get_count(LatencyStage::gpu_complete));
+    EXPECT_EQ(1'000, trace.get_percentile_ns(LatencyStage::gpu_complete, 0.0));
+    EXPECT_EQ(50'000, trace.get_percentile_ns(LatencyStage::gpu_complete, 50.0));
+    EXPECT_EQ(90'000, trace.get_percentile_ns(LatencyStage::gpu_complete, 90.0));
+    EXPECT_EQ(99'000, trace.get_percentile_ns(LatencyStage::gpu_complete, 99.0));
+    EXPECT_EQ(100'000, trace.get_percentile_ns(LatencyStage::gpu_complete, 100.0));
+}
+
+TEST(LatencyTraceTest, FormatsEveryStage) {
+    LatencyTrace trace;
+    trace.add(LatencyStage::swapped, 0, 2'000'000);
+
+    auto const formatted = std::format("{}", trace);
+    for (std::size_t i = 0; i < LatencyTrace::num_stages; ++i) {
+        EXPECT_NE(std::string::npos, formatted.find(LatencyTrace::get_stage_name(static_cast<LatencyStage>(i))));
+    }
+    EXPECT_NE(std::string::npos, formatted.find("p50 2.000"));
+}
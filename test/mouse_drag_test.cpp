@@ -0,0 +1,102 @@
+#include "mouse_drag.hpp"
+#include "mouse_loc.hpp"
+
+#include <SDL3/SDL.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <numbers>
+
+#include <glm/gtc/quaternion.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+static constexpr Uint8 left = 1;
+static constexpr Uint8 right = 3;
+static constexpr glm::vec2 window_size{1200.0f, 800.0f};
+
+TEST(MouseDragTest, NothingWithoutAButtonHeld) {
+    MouseDrag drag;
+    drag.move(MouseLoc{10.0f, 10.0f});
+    EXPECT_FALSE(drag.is_dragging());
+    EXPECT_FALSE(drag.take().has_value());
+}
+
+TEST(MouseDragTest, AccumulatesMotionIntoOneDelta) {
+    MouseDrag drag;
+    drag.press(left, MouseLoc{100.0f, 100.0f});
+    for (int i = 1; i <= 500; ++i) {
+        drag.move(MouseLoc{100.0f + static_cast<float>(i), 100.0f - static_cast<float>(i) / 2.0f});
+    }
+
+    auto const delta = drag.take();
+    ASSERT_TRUE(delta.has_value());
+    EXPECT_EQ(left, delta->button);
+    EXPECT_EQ(glm::vec2(100.0f, 100.0f), delta->from.to_vec());
+    EXPECT_EQ(glm::vec2(600.0f, -150.0f), delta->to.to_vec());
+
+    // picks up where it was applied up to
+    EXPECT_FALSE(drag.take().has_value());
+    drag.move(MouseLoc{610.0f, -150.0f});
+    EXPECT_EQ(glm::vec2(600.0f, -150.0f), drag.take()->from.to_vec());
+    EXPECT_TRUE(drag.is_dragging());
+}
+
+TEST(MouseDragTest, MovementUpToTheReleaseIsKept) {
+    MouseDrag drag;
+    drag.press(right, MouseLoc{0.0f, 0.0f});
+    drag.move(MouseLoc{5.0f, 0.0f});
+    drag.release(right, MouseLoc{8.0f, 0.0f});
+    drag.move(MouseLoc{50.0f, 0.0f});
+
+    EXPECT_TRUE(drag.is_dragging());
+    auto const delta = drag.take();
+    ASSERT_TRUE(delta.has_value());
+    EXPECT_EQ(right, delta->button);
+    EXPECT_EQ(glm::vec2(8.0f, 0.0f), delta->to.to_vec());
+    EXPECT_FALSE(drag.is_dragging());
+}
+
+TEST(MouseDragTest, OneButtonAtATime) {
+    MouseDrag drag;
+    drag.press(left, MouseLoc{0.0f, 0.0f});
+    drag.press(right, MouseLoc{5.0f, 5.0f});
+    drag.release(right, MouseLoc{5.0f, 5.0f});
+    drag.move(MouseLoc{10.0f, 0.0f});
+
+    auto const delta = drag.take();
+    ASSERT_TRUE(delta.has_value());
+    EXPECT_EQ(left, delta->button);
+    EXPECT_EQ(glm::vec2(0.0f, 0.0f), delta->from.to_vec());
+    EXPECT_TRUE(drag.is_dragging());
+}
+
+TEST(ArcballTest, NoMovementNoRotation) {
+    auto const rotation = arcball_rotation(MouseLoc{300.0f, 200.0f}, MouseLoc{300.0f, 200.0f}, window_size);
+    EXPECT_NEAR(1.0f, rotation.w, 1e-6f);
+}
+
+TEST(ArcballTest, DraggingRightFromTheCenterTurnsAboutY) {
+    // from the center to the rim of the sphere is a quarter turn
+    auto const rotation = arcball_rotation(MouseLoc{600.0f, 400.0f}, MouseLoc{1000.0f, 400.0f}, window_size);
+    EXPECT_NEAR(std::numbers::pi_v<float> / 2.0f, glm::angle(rotation), 1e-5f);
+
+    auto const axis = glm::axis(rotation);
+    EXPECT_NEAR(0.0f, axis.x, 1e-5f);
+    EXPECT_NEAR(1.0f, axis.y, 1e-5f);
+    EXPECT_NEAR(0.0f, axis.z, 1e-5f);
+}
+
+TEST(ArcballTest, DraggingUpTurnsTheFrontUp) {
+    // window y is down, dragging up tips the near side of the sphere up, about -x
+    auto const rotation = arcball_rotation(MouseLoc{600.0f, 400.0f}, MouseLoc{600.0f, 300.0f}, window_size);
+    auto const front = rotation * glm::vec3{0.0f, 0.0f, 1.0f};
+    EXPECT_GT(front.y, 0.0f);
+    EXPECT_LT(glm::axis(rotation).x, 0.0f);
+}
+
+TEST(ArcballTest, DraggingBackUndoes) {
+    auto const there = arcball_rotation(MouseLoc{500.0f, 300.0f}, MouseLoc{700.0f, 450.0f}, window_size);
+    auto const back = arcball_rotation(MouseLoc{700.0f, 450.0f}, MouseLoc{500.0f, 300.0f}, window_size);
+    EXPECT_NEAR(1.0f, std::abs((back * there).w), 1e-5f);
+}
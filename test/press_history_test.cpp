@@ -0,0 +1,82 @@
+#include "press_history.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <optional>
+
+using std::nullopt;
+
+TEST(PressHistoryTest, StartsEmpty) {
+    const PressHistory history;
+    EXPECT_EQ(0, history.size());
+    EXPECT_FALSE(history.is_held());
+    EXPECT_EQ(nullopt, history.last());
+    EXPECT_EQ(0, history.held_ns(0, 100));
+}
+
+TEST(PressHistoryTest, PressAndRelease) {
+    PressHistory history;
+    history.press(10);
+    EXPECT_TRUE(history.is_held());
+    EXPECT_EQ((Interval{10, nullopt}), history.last());
+
+    // pressing while held does not restart the press
+    history.press(15);
+    EXPECT_EQ(1, history.size());
+
+    history.release(20);
+    EXPECT_FALSE(history.is_held());
+    EXPECT_EQ((Interval{10, 20}), history.last());
+
+    // releasing again does not move the end
+    history.release(25);
+    EXPECT_EQ((Interval{10, 20}), history.last());
+}
+
+TEST(PressHistoryTest, ReleaseWithoutPress) {
+    PressHistory history;
+    history.release(10);
+    EXPECT_EQ((Interval{10, 10}), history.last());
+    EXPECT_EQ(0, history.held_ns(0, 100));
+}
+
+TEST(PressHistoryTest, HeldNsCountsEveryPressInTheWindow) {
+    PressHistory history;
+
+    // tapped twice and pressed again within one frame
+    history.press(100);
+    history.release(104);
+    history.press(106);
+    history.release(109);
+    history.press(115);
+
+    EXPECT_EQ(4 + 3 + 5, history.held_ns(100, 120));
+    EXPECT_EQ(2 + 3 + 5, history.held_ns(102, 120));
+    EXPECT_EQ(3, history.held_ns(105, 110));
+    EXPECT_EQ(0, history.held_ns(109, 115));
+    EXPECT_EQ(0, history.held_ns(50, 100));
+}
+
+TEST(PressHistoryTest, HeldAcrossTheWholeWindow) {
+    PressHistory history;
+    history.press(10);
+    EXPECT_EQ(16, history.held_ns(100, 116));
+
+    history.release(110);
+    EXPECT_EQ(10, history.held_ns(100, 116));
+}
+
+TEST(PressHistoryTest, OldestPressesAreOverwritten) {
+    PressHistory history;
+    for (uint64_t i = 0; i < PressHistory::capacity * 2; ++i) {
+        history.press(i * 10);
+        history.release(i * 10 + 5);
+    }
+
+    EXPECT_EQ(PressHistory::capacity, history.size());
+    EXPECT_EQ(PressHistory::capacity * 5, history.held_ns(0, PressHistory::capacity * 20));
+
+    auto const last_start = (PressHistory::capacity * 2 - 1) * 10;
+    EXPECT_EQ((Interval{last_start, last_start + 5}), history.last());
+}
@@ -0,0 +1,47 @@
+#include "progressive_refinement.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(ProgressiveRefinementTest, StartsRefined) {
+    const ProgressiveRefinement refinement{2, 9};
+    EXPECT_TRUE(refinement.is_refined(9));
+    EXPECT_EQ(9, refinement.get_level());
+}
+
+TEST(ProgressiveRefinementTest, CoarsenThenDoubleUpToTarget) {
+    ProgressiveRefinement refinement{2, 9};
+    EXPECT_EQ(2, refinement.coarsen(9));
+    EXPECT_FALSE(refinement.is_refined(9));
+
+    EXPECT_EQ(4, refinement.refine(9));
+    EXPECT_EQ(8, refinement.refine(9));
+    EXPECT_EQ(9, refinement.refine(9));
+    EXPECT_TRUE(refinement.is_refined(9));
+
+    EXPECT_EQ(9, refinement.refine(9));
+}
+
+TEST(ProgressiveRefinementTest, NeverCoarserThanTarget) {
+    ProgressiveRefinement refinement{4, 9};
+    EXPECT_EQ(3, refinement.coarsen(3));
+    EXPECT_TRUE(refinement.is_refined(3));
+}
+
+TEST(ProgressiveRefinementTest, FollowsAMovingTarget) {
+    ProgressiveRefinement refinement{2, 16};
+    refinement.coarsen(16);
+    EXPECT_EQ(4, refinement.refine(16));
+
+    // e.g. the quality governor lowered the level mid refinement
+    EXPECT_EQ(3, refinement.refine(3));
+    EXPECT_TRUE(refinement.is_refined(3));
+
+    EXPECT_EQ(6, refinement.refine(12));
+}
+
+TEST(ProgressiveRefinementTest, SetLevelSkipsRefinement) {
+    ProgressiveRefinement refinement{2, 9};
+    refinement.coarsen(9);
+    EXPECT_EQ(12, refinement.set_level(12));
+    EXPECT_TRUE(refinement.is_refined(12));
+}
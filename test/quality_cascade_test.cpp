@@ -0,0 +1,101 @@
+#include "quality_cascade.hpp"
+#include "quality_governor.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+using std::size_t;
+
+class QualityCascadeTest : public testing::Test {
+protected:
+    static constexpr uint64_t budget_ns = 16'000'000;
+    static constexpr uint64_t slow_frame_ns = budget_ns * 2;
+    static constexpr uint64_t fast_frame_ns = budget_ns / 4;
+
+    static constexpr GLuint min_resolution_step = 4;
+    static constexpr GLuint resolution_steps = 8;
+    static constexpr GLuint min_tessellation_level = 1;
+    static constexpr GLuint requested_tessellation_level = 9;
+
+    /** more than enough frames for either governor to go from one end to the other */
+    static constexpr size_t long_run_frames = QualityGovernor::window_frames * 40;
+
+    QualityCascade cascade{budget_ns, min_resolution_step, resolution_steps, min_tessellation_level,
+                           requested_tessellation_level};
+
+    /**
+     * feed frames checking that resolution and tessellation take turns in the right order
+     */
+    void feed(uint64_t frame_time_ns, size_t frames, FrameTessellation tessellation = FrameTessellation::governed) {
+        for (size_t i = 0; i < frames; ++i) {
+            auto const change = cascade.add_frame_time(frame_time_ns, tessellation);
+            ASSERT_FALSE(change.resolution_step.has_value() && change.tessellation_level.has_value());
+
+            if (change.tessellation_level.has_value()) {
+                // only once the resolution can not go any lower
+                EXPECT_EQ(min_resolution_step, cascade.get_resolution_step());
+            }
+            if (change.resolution_step.has_value()) {
+                // only with tessellation as requested
+                EXPECT_EQ(requested_tessellation_level, cascade.get_tessellation_level());
+            }
+        }
+    }
+};
+
+TEST_F(QualityCascadeTest, StartsAtFullQuality) {
+    EXPECT_EQ(resolution_steps, cascade.get_resolution_step());
+    EXPECT_EQ(requested_tessellation_level, cascade.get_tessellation_level());
+}
+
+TEST_F(QualityCascadeTest, LowersResolutionFirst) {
+    feed(slow_frame_ns, QualityGovernor::window_frames);
+    EXPECT_GT(resolution_steps, cascade.get_resolution_step());
+    EXPECT_EQ(requested_tessellation_level, cascade.get_tessellation_level());
+}
+
+TEST_F(QualityCascadeTest, DropsThenRecovers) {
+    feed(slow_frame_ns, long_run_frames);
+    EXPECT_EQ(min_resolution_step, cascade.get_resolution_step());
+    EXPECT_EQ(min_tessellation_level, cascade.get_tessellation_level());
+
+    feed(fast_frame_ns, long_run_frames);
+    EXPECT_EQ(resolution_steps, cascade.get_resolution_step());
+    EXPECT_EQ(requested_tessellation_level, cascade.get_tessellation_level());
+}
+
+TEST_F(QualityCascadeTest, RecoversFromMinResolutionAlone) {
+    // just enough load to bottom out the resolution, tessellation is never touched
+    while (cascade.get_resolution_step() > min_resolution_step) {
+        feed(slow_frame_ns, 1);
+    }
+    EXPECT_EQ(requested_tessellation_level, cascade.get_tessellation_level());
+
+    feed(fast_frame_ns, long_run_frames);
+    EXPECT_EQ(resolution_steps, cascade.get_resolution_step());
+}
+
+TEST_F(QualityCascadeTest, UntessellatedFramesOnlyGovernResolution) {
+    feed(slow_frame_ns, long_run_frames, FrameTessellation::none);
+    EXPECT_EQ(min_resolution_step, cascade.get_resolution_step());
+    EXPECT_EQ(requested_tessellation_level, cascade.get_tessellation_level());
+
+    feed(fast_frame_ns, long_run_frames, FrameTessellation::none);
+    EXPECT_EQ(resolution_steps, cascade.get_resolution_step());
+}
+
+TEST_F(QualityCascadeTest, CoarseFramesWaitForTessellation) {
+    feed(slow_frame_ns, long_run_frames);
+    ASSERT_EQ(min_tessellation_level, cascade.get_tessellation_level());
+
+    // fast because they are coarse, not because there is headroom at the governed level
+    feed(fast_frame_ns, long_run_frames, FrameTessellation::coarse);
+    EXPECT_EQ(min_resolution_step, cascade.get_resolution_step());
+    EXPECT_EQ(min_tessellation_level, cascade.get_tessellation_level());
+
+    feed(fast_frame_ns, long_run_frames);
+    EXPECT_EQ(resolution_steps, cascade.get_resolution_step());
+    EXPECT_EQ(requested_tessellation_level, cascade.get_tessellation_level());
+}
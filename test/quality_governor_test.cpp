@@ -0,0 +1,81 @@
+#include "quality_governor.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include <gtest/gtest.h>
+
+using std::size_t;
+
+class QualityGovernorTest : public testing::Test {
+protected:
+    static constexpr uint64_t budget_ns = 16'000'000;
+    static constexpr uint64_t slow_frame_ns = budget_ns * 2;
+    static constexpr uint64_t fast_frame_ns = budget_ns / 4;
+    static constexpr uint64_t on_budget_frame_ns = budget_ns * 3 / 4;
+
+    /**
+     * @return the level after feeding a full window of frames
+     */
+    static GLuint feed_window(QualityGovernor &governor, uint64_t frame_time_ns) {
+        for (size_t i = 0; i < QualityGovernor::window_frames; ++i) {
+            static_cast<void>(governor.add_frame_time(frame_time_ns));
+        }
+
+        return governor.get_level();
+    }
+};
+
+TEST_F(QualityGovernorTest, StartsAtRequested) {
+    const QualityGovernor governor{budget_ns, 1, 9};
+    EXPECT_EQ(9, governor.get_level());
+    EXPECT_EQ(1, governor.get_min_level());
+}
+
+TEST_F(QualityGovernorTest, WaitsForAFullWindow) {
+    QualityGovernor governor{budget_ns, 1, 8};
+    for (size_t i = 0; i + 1 < QualityGovernor::window_frames; ++i) {
+        EXPECT_FALSE(governor.add_frame_time(slow_frame_ns).has_value());
+    }
+
+    EXPECT_EQ(6, governor.add_frame_time(slow_frame_ns));
+}
+
+TEST_F(QualityGovernorTest, LowersUnderLoadDownToMin) {
+    QualityGovernor governor{budget_ns, 2, 16};
+    EXPECT_EQ(12, feed_window(governor, slow_frame_ns));
+
+    for (int i = 0; i < 20; ++i) {
+        feed_window(governor, slow_frame_ns);
+    }
+    EXPECT_EQ(2, governor.get_level());
+}
+
+TEST_F(QualityGovernorTest, RecoversButNeverAboveRequested) {
+    QualityGovernor governor{budget_ns, 1, 8};
+    EXPECT_EQ(6, feed_window(governor, slow_frame_ns));
+
+    EXPECT_EQ(7, feed_window(governor, fast_frame_ns));
+    EXPECT_EQ(8, feed_window(governor, fast_frame_ns));
+    EXPECT_EQ(8, feed_window(governor, fast_frame_ns));
+}
+
+TEST_F(QualityGovernorTest, HoldsInsideTheHysteresisBand) {
+    QualityGovernor governor{budget_ns, 1, 8};
+    EXPECT_EQ(6, feed_window(governor, slow_frame_ns));
+
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(6, feed_window(governor, on_budget_frame_ns));
+    }
+}
+
+TEST_F(QualityGovernorTest, RequestedLevelIsTheCeiling) {
+    QualityGovernor governor{budget_ns, 1, 8};
+    EXPECT_EQ(4, governor.set_requested_level(4));
+    EXPECT_EQ(4, feed_window(governor, fast_frame_ns));
+
+    // the user asking for more is honored right away
+    EXPECT_EQ(10, governor.set_requested_level(10));
+    EXPECT_EQ(10, governor.get_requested_level());
+}
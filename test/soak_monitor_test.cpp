@@ -0,0 +1,72 @@
+#include "soak_monitor.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <format>
+#include <string>
+
+static constexpr uint64_t interval_ns = 1'000'000'000;
+
+TEST(SoakMonitorTest, NothingBeforeTheFirstInterval) {
+    const SoakMonitor monitor{interval_ns, 0};
+    EXPECT_FALSE(monitor.get_latest().has_value());
+    EXPECT_EQ(0.0, monitor.get_frame_time_drift_ns());
+    EXPECT_EQ(0, monitor.get_memory_growth_bytes());
+    EXPECT_EQ(0, monitor.get_gl_object_growth());
+    EXPECT_FALSE(monitor.is_interval_over(interval_ns - 1));
+    EXPECT_TRUE(monitor.is_interval_over(interval_ns));
+}
+
+TEST(SoakMonitorTest, FirstIntervalIsTheBaseline) {
+    SoakMonitor monitor{interval_ns, 0};
+    monitor.add_frame_time(16'000'000);
+    monitor.add_frame_time(18'000'000);
+    monitor.end_interval(interval_ns, 4096, 20);
+
+    ASSERT_TRUE(monitor.get_baseline().has_value());
+    EXPECT_DOUBLE_EQ(17'000'000.0, monitor.get_baseline()->frame_times.get_mean_ns());
+    EXPECT_EQ(0.0, monitor.get_frame_time_drift_ns());
+    EXPECT_EQ(0, monitor.get_memory_growth_bytes());
+    EXPECT_EQ(1, monitor.get_interval_count());
+
+    // the next interval starts where this one ended
+    EXPECT_FALSE(monitor.is_interval_over(interval_ns * 2 - 1));
+}
+
+TEST(SoakMonitorTest, LaterIntervalsAreComparedToTheBaseline) {
+    SoakMonitor monitor{interval_ns, 0};
+    monitor.add_frame_time(16'000'000);
+    monitor.end_interval(interval_ns, 4096, 20);
+
+    monitor.add_frame_time(20'000'000);
+    monitor.add_frame_time(22'000'000);
+    monitor.end_interval(interval_ns * 2, 8192, 23);
+
+    EXPECT_DOUBLE_EQ(5'000'000.0, monitor.get_frame_time_drift_ns());
+    EXPECT_EQ(4096, monitor.get_memory_growth_bytes());
+    EXPECT_EQ(3, monitor.get_gl_object_growth());
+    EXPECT_EQ(2, monitor.get_latest()->frame_times.get_count());
+
+    monitor.end_interval(interval_ns * 3, 2048, 18);
+    EXPECT_EQ(-2048, monitor.get_memory_growth_bytes());
+    EXPECT_EQ(-2, monitor.get_gl_object_growth());
+}
+
+TEST(SoakMonitorTest, UnknownMemoryHasNoGrowth) {
+    SoakMonitor monitor{interval_ns, 0};
+    monitor.end_interval(interval_ns, std::nullopt, 0);
+    monitor.end_interval(interval_ns * 2, 8192, 0);
+    EXPECT_EQ(0, monitor.get_memory_growth_bytes());
+}
+
+TEST(SoakMonitorTest, Formats) {
+    SoakMonitor monitor{interval_ns, 0};
+    EXPECT_EQ("< SoakMonitor no intervals >", std::format("{}", monitor));
+
+    monitor.add_frame_time(16'000'000);
+    monitor.end_interval(interval_ns, 4096, 20);
+    auto const formatted = std::format("{}", monitor);
+    EXPECT_NE(std::string::npos, formatted.find("drift +0.000 ms"));
+    EXPECT_NE(std::string::npos, formatted.find("gl objects 20 growth +0"));
+}
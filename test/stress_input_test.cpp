@@ -0,0 +1,87 @@
+#include "stress_input.hpp"
+
+#include <SDL3/SDL.h>
+#include <gtest/gtest.h>
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+
+static constexpr uint64_t events_per_second = 2'000;
+static constexpr uint64_t duration_ns = 1'000'000'000;
+static constexpr std::size_t num_events = 5'000;
+
+TEST(StressInputTest, SameSeedSameEvents) {
+    StressInput first{events_per_second, duration_ns, 7};
+    StressInput second{events_per_second, duration_ns, 7};
+    for (std::size_t i = 0; i < num_events; ++i) {
+        auto const a = first.next_event(i);
+        auto const b = second.next_event(i);
+        ASSERT_EQ(0, std::memcmp(&a, &b, sizeof(SDL_Event))) << "event " << i;
+    }
+}
+
+TEST(StressInputTest, DifferentSeedsDiffer) {
+    StressInput first{events_per_second, duration_ns, 7};
+    StressInput second{events_per_second, duration_ns, 8};
+
+    std::size_t same = 0;
+    for (std::size_t i = 0; i < num_events; ++i) {
+        auto const a = first.next_event(i);
+        auto const b = second.next_event(i);
+        same += std::memcmp(&a, &b, sizeof(SDL_Event)) == 0 ? 1 : 0;
+    }
+    EXPECT_LT(same, num_events / 2);
+}
+
+TEST(StressInputTest, MixesEveryKindOfEvent) {
+    StressInput input{events_per_second, duration_ns, 1};
+    std::map<Uint32, std::size_t> counts;
+    for (std::size_t i = 0; i < num_events; ++i) {
+        ++counts[input.next_event(i).type];
+    }
+
+    for (auto const type : {SDL_EVENT_KEY_DOWN, SDL_EVENT_KEY_UP, SDL_EVENT_MOUSE_WHEEL, SDL_EVENT_MOUSE_MOTION,
+                            SDL_EVENT_MOUSE_BUTTON_DOWN, SDL_EVENT_MOUSE_BUTTON_UP}) {
+        EXPECT_GT(counts[type], 0) << "type " << type;
+    }
+    EXPECT_EQ(0, counts[SDL_EVENT_QUIT]);
+}
+
+TEST(StressInputTest, KeysAreReleasedOnlyOnceHeldAndAllLetGo) {
+    StressInput input{events_per_second, duration_ns, 3};
+    std::bitset<SDL_SCANCODE_COUNT> held;
+    bool button_held = false;
+
+    auto const check = [&](SDL_Event const &event) {
+        if (event.type == SDL_EVENT_KEY_DOWN) {
+            EXPECT_EQ(event.key.repeat, held.test(event.key.scancode));
+            held.set(event.key.scancode);
+        }
+        else if (event.type == SDL_EVENT_KEY_UP) {
+            EXPECT_TRUE(held.test(event.key.scancode));
+            held.reset(event.key.scancode);
+        }
+        else if (event.type == SDL_EVENT_MOUSE_BUTTON_DOWN) {
+            EXPECT_FALSE(button_held);
+            button_held = true;
+        }
+        else if (event.type == SDL_EVENT_MOUSE_BUTTON_UP) {
+            EXPECT_TRUE(button_held);
+            button_held = false;
+        }
+    };
+
+    for (std::size_t i = 0; i < num_events; ++i) {
+        check(input.next_event(i));
+    }
+    for (auto const &event : input.release_all(num_events)) {
+        check(event);
+    }
+
+    EXPECT_TRUE(held.none());
+    EXPECT_FALSE(button_held);
+    EXPECT_TRUE(input.release_all(num_events).empty());
+}
@@ -0,0 +1,40 @@
+#include "synthetic_input.hpp"
+
+#include <SDL3/SDL.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+
+TEST(SyntheticInputTest, PressesThenQuits) {
+    const SyntheticInput input{3, 100, 40};
+    ASSERT_EQ(7, input.get_event_count());
+
+    for (std::size_t i = 0; i + 1 < input.get_event_count(); i += 2) {
+        auto const down = input.get_event(i, 1'000);
+        auto const up = input.get_event(i + 1, 1'000);
+
+        EXPECT_EQ(static_cast<Uint32>(SDL_EVENT_KEY_DOWN), down.type);
+        EXPECT_TRUE(down.key.down);
+        EXPECT_EQ(static_cast<Uint32>(SDL_EVENT_KEY_UP), up.type);
+        EXPECT_FALSE(up.key.down);
+        EXPECT_EQ(down.key.scancode, up.key.scancode);
+
+        EXPECT_EQ(1'000 + (i / 2) * 100, down.key.timestamp);
+        EXPECT_EQ(down.key.timestamp + 40, up.key.timestamp);
+    }
+
+    auto const quit = input.get_event(6, 1'000);
+    EXPECT_EQ(static_cast<Uint32>(SDL_EVENT_QUIT), quit.type);
+    EXPECT_EQ(1'300, quit.quit.timestamp);
+}
+
+TEST(SyntheticInputTest, CyclesThroughMovementKeys) {
+    const SyntheticInput input{2, 100, 40};
+    EXPECT_NE(input.get_event(0, 0).key.scancode, input.get_event(2, 0).key.scancode);
+}
+
+TEST(SyntheticInputTest, HoldIsShorterThanTheInterval) {
+    const SyntheticInput input{1, 100, 400};
+    EXPECT_LE(input.get_event(1, 0).key.timestamp, 100);
+}
@@ -0,0 +1,79 @@
+#include "triple_buffer.hpp"
+
+#include <cstdint>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+TEST(TripleBuffer, InitialValue) {
+    TripleBuffer<int> buffer{7};
+    EXPECT_EQ(7, buffer.read());
+    EXPECT_FALSE(buffer.update());
+    EXPECT_EQ(7, buffer.read());
+}
+
+TEST(TripleBuffer, UpdateSeesLatest) {
+    TripleBuffer<int> buffer;
+    buffer.publish(1);
+    buffer.publish(2);
+    buffer.publish(3);
+
+    EXPECT_TRUE(buffer.update());
+    EXPECT_EQ(3, buffer.read());
+
+    // nothing new
+    EXPECT_FALSE(buffer.update());
+    EXPECT_EQ(3, buffer.read());
+
+    buffer.publish(4);
+    EXPECT_TRUE(buffer.update());
+    EXPECT_EQ(4, buffer.read());
+}
+
+TEST(TripleBuffer, ReadIsStableUntilUpdate) {
+    TripleBuffer<int> buffer;
+    buffer.publish(1);
+    ASSERT_TRUE(buffer.update());
+
+    buffer.publish(2);
+    buffer.publish(3);
+    EXPECT_EQ(1, buffer.read());
+}
+
+namespace {
+/** both halves are written together, a torn read would see them differ */
+struct Pair {
+    uint64_t a = 0;
+    uint64_t b = 0;
+};
+} // namespace
+
+TEST(TripleBuffer, ConcurrentReadsAreConsistentAndMonotonic) {
+    constexpr uint64_t num_publishes = 200'000;
+    TripleBuffer<Pair> buffer;
+
+    std::thread writer{[&] {
+        for (uint64_t i = 1; i <= num_publishes; ++i) {
+            buffer.publish(Pair{i, i});
+        }
+    }};
+
+    uint64_t last_seen = 0;
+    while (last_seen < num_publishes) {
+        if (!buffer.update()) {
+            continue;
+        }
+
+        // an ASSERT would return with the writer still joinable and terminate instead of failing
+        auto const &value = buffer.read();
+        EXPECT_EQ(value.a, value.b);
+        EXPECT_GT(value.a, last_seen);
+        if (value.a != value.b || value.a <= last_seen) {
+            break;
+        }
+        last_seen = value.a;
+    }
+
+    writer.join();
+    EXPECT_EQ(num_publishes, last_seen);
+}